@@ -13,19 +13,54 @@
 #include <cstring>
 #include <algorithm>
 #include <errno.h>
+#include <climits>
+#include <getopt.h>
+#include <atomic>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/prctl.h>
+#include <linux/futex.h>
+#include <sched.h>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <cstdarg>
+#include <cstdint>
+#include <fcntl.h>
+#include <coroutine>
+#include <mutex>
+#include <condition_variable>
 
 // 1. 시스템 상수 및 설정
 #define CHILD_COUNT 10       // 생성할 자식 프로세스 수
 #define T_QUANTUM 3          // Time Quantum (Time Slice)
 #define SIM_LIMIT 10000      // 시뮬레이션 종료 시간 (Tick)
-#define Q_KEY 12345          // 메시지 큐 식별자 키
+#define RING_SLOTS 8         // 공유 메모리 링 버퍼 슬롯 수 (채널당)
+#define SPIN_LIMIT 256       // futex 대기 전 busy-wait 횟수
+#define WHEEL_SLOTS 64       // I/O 타이밍 휠 슬롯 수 (2의 거듭제곱)
+#define MAX_CPUS 256         // 시뮬레이션 CPU 코어 수 상한
+#define RESP_MTYPE_BASE (1L << 30) // 자식 -> 커널 응답의 메시지 타입 = RESP_MTYPE_BASE + 자식 PID
+#define HIST_SUB_BITS 5      // 히스토그램 정밀도: 2^k 구간마다 2^HIST_SUB_BITS칸 (상대 오차 약 3%)
+#define BENCH_MIN_NS 200000000L // 마이크로벤치마크 항목별 최소 측정 시간 (ns)
+#define BENCH_PROCS 64       // 마이크로벤치마크의 PCB 수
+
+// 스케줄링 정책 파라미터
+#define MLFQ_LEVELS 3        // MLFQ 우선순위 단계 수 (단계 k의 Quantum = T_QUANTUM * 2^k)
+#define MLFQ_BOOST 100       // MLFQ 전체 우선순위 초기화 주기 (Tick)
+#define CFS_LATENCY 12       // CFS 목표 스케줄링 주기 (Tick)
+#define CFS_MIN_GRAN 1       // CFS 최소 Time Slice (Tick)
+#define CFS_WAKEUP_GRAN 2    // CFS 깨어난 프로세스의 선점 허용 vruntime 차이
 
 // 2. 프로토콜 및 데이터 구조
 
 // 부모(커널) -> 자식(유저)에게 명령
 enum ParentCommand {
-    CMD_EXECUTE_TICK = 1, // 1 tick 실행 명령
-    CMD_TERMINATE = -1    // 시뮬레이션 종료 명령
+    CMD_EXECUTE_TICK = 1,  // 1 tick 실행 명령
+    CMD_EXECUTE_BATCH = 2, // 최대 arg tick 실행 명령 (I/O 요청 시 중단)
+    CMD_TERMINATE = -1     // 시뮬레이션 종료 명령
 };
 
 // 자식(유저) -> 부모(커널) 응답
@@ -38,77 +73,1032 @@ enum ChildResponse {
 struct IpcMsg {
     long mtype;       // 메시지 타겟 (PID)
     int command;      // 명령어 또는 상태 데이터
+    int arg;          // 명령: 배치 Tick 수 / 응답: 실제 실행한 Tick 수
 };
+#define IPC_MSG_SIZE (sizeof(IpcMsg) - sizeof(long))
 
 // 프로세스 제어 블록 (PCB)
 struct ProcInfo {
     pid_t pid;          // 프로세스 ID
     int cpu_time;       // 남은 CPU Burst Time
-    int io_time;        // 남은 I/O Wait Time
+    int io_time;        // 남은 I/O Wait Time (Block 시점 값, 현재 남은 시간은 io_done - sys_tick)
+    int io_done;        // I/O 완료 예정 시각 (Tick)
     bool is_waiting;    // Blocked 상태 여부
+    int mlfq_level;     // MLFQ 현재 우선순위 단계
+    long vruntime;      // CFS 가상 실행 시간
+    int ready_since;    // Ready Queue 진입 시각 (대기 시간 계산용)
+    int burst_start;    // 현재 CPU Burst가 Ready 상태가 된 시각
+    bool responded;     // 현재 Burst에서 Dispatch된 적이 있는지 여부
+    int cpu;            // 소속 코어 (이 코어의 Run Queue에 들어감)
+    int last_cpu;       // 마지막으로 실행된 코어 (-1: 아직 실행 안 됨)
+
+    // 프로세스별 성능 지표
+    long cpu_ticks;         // 실행한 Tick 수
+    long io_ticks;          // 요청한 I/O 시간 합
+    long bursts;            // 완료한 CPU Burst 수
+    long dispatch_count;    // Dispatch 횟수
+    long wait_sum;          // Ready Queue 대기 시간 합
+    long response_sum;      // 응답 시간 합
+    long turnaround_sum;    // 반환 시간 합
+};
+
+// 정책 비교용 통계 (CPU Burst = Ready 진입부터 I/O 요청까지)
+struct SchedStats {
+    long bursts;            // 완료된 CPU Burst 수
+    long total_wait;        // Ready Queue 대기 시간 합
+    long total_response;    // Ready 진입 -> 첫 Dispatch 시간 합
+    long total_turnaround;  // Ready 진입 -> I/O 요청 시간 합
+    long dispatches;        // Dispatch 횟수
+    long preemptions;       // 우선순위에 의한 선점 횟수
+    long migrations;        // 이전과 다른 코어에서 실행된 횟수
+    long imbalance_sum;     // Tick별 코어 부하 차이(최대 - 최소) 합
+    long round_trips;       // 실행 명령 IPC 왕복 횟수
+    long context_switches;  // 코어에서 다른 프로세스로 교체된 횟수
+};
+
+// HDR 스타일 로그-선형 히스토그램
+// 값을 2의 거듭제곱 구간으로 나누고, 각 구간을 다시 2^HIST_SUB_BITS칸으로 균등 분할함
+#define HIST_SUB_BUCKETS (1 << HIST_SUB_BITS)
+#define HIST_BUCKETS ((64 - HIST_SUB_BITS + 1) * HIST_SUB_BUCKETS)
+
+struct LatencyHistogram {
+    uint64_t counts[HIST_BUCKETS] = {};
+    uint64_t total = 0;
+    uint64_t sum = 0;
+    uint64_t min = UINT64_MAX;
+    uint64_t max = 0;
+
+    static int index_of(uint64_t v) {
+        if (v < HIST_SUB_BUCKETS) return (int)v;
+        int shift = 63 - __builtin_clzll(v) - HIST_SUB_BITS;
+        return (shift + 1) * HIST_SUB_BUCKETS + (int)((v >> shift) - HIST_SUB_BUCKETS);
+    }
+
+    // 칸의 하한 값
+    static uint64_t value_of(int idx) {
+        if (idx < HIST_SUB_BUCKETS) return idx;
+        int shift = idx / HIST_SUB_BUCKETS - 1;
+        return (uint64_t)(idx % HIST_SUB_BUCKETS + HIST_SUB_BUCKETS) << shift;
+    }
+
+    void record(uint64_t v) {
+        counts[index_of(v)]++;
+        total++;
+        sum += v;
+        min = std::min(min, v);
+        max = std::max(max, v);
+    }
+
+    uint64_t percentile(double pct) const {
+        if (total == 0) return 0;
+        uint64_t rank = (uint64_t)(pct / 100.0 * total + 0.5);
+        if (rank < 1) rank = 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < HIST_BUCKETS; ++i) {
+            seen += counts[i];
+            if (seen >= rank) return std::min(std::max(value_of(i), min), max);
+        }
+        return max;
+    }
+
+    double mean() const { return total ? (double)sum / total : 0.0; }
 };
 
 // 3. 전역 변수
 int mq_id;                      // 메시지 큐 ID
 int sys_tick = 0;               // 시스템 현재 시간 (Tick)
 volatile sig_atomic_t alarm_triggered = 0; // 타이머 시그널 플래그
-int q_counter = 0;              // 현재 프로세스의 남은 Time Quantum
+int t_quantum = T_QUANTUM;      // RR/MLFQ 기본 Time Quantum
+int child_count = CHILD_COUNT;  // 생성할 자식 프로세스 수
+bool batch_mode = false;        // Quantum 단위 배치 실행 (CMD_EXECUTE_BATCH)
+SchedStats stats = {};
+LatencyHistogram rtt_hist;      // Dispatch 왕복(명령 전송 -> 응답 수신) 지연 (ns)
+
+// PID -> p_table 인덱스 (PCB 조회를 O(1)로)
+std::unordered_map<pid_t, int> pid_index;
+
+// Hashed Timing Wheel: Block된 프로세스를 I/O 완료 시각 기준 슬롯에 보관
+// 매 Tick 현재 슬롯 하나만 검사하므로 비용이 전체 프로세스 수가 아닌 이벤트 수에 비례함
+struct TimerWheel {
+    std::vector<int> slots[WHEEL_SLOTS]; // p_table 인덱스 (만료 시각 % WHEEL_SLOTS)
+    size_t pending = 0;
+
+    void schedule(int idx, int expire_tick) {
+        slots[expire_tick & (WHEEL_SLOTS - 1)].push_back(idx);
+        pending++;
+    }
+
+    // tick에 만료되는 항목을 out에 꺼냄 (슬롯에 남은 항목은 이후 바퀴에 만료)
+    void expire(int tick, const std::vector<ProcInfo>& p_table, std::vector<int>& out) {
+        std::vector<int>& slot = slots[tick & (WHEEL_SLOTS - 1)];
+        for (size_t i = 0; i < slot.size(); ) {
+            if (p_table[slot[i]].io_done <= tick) {
+                out.push_back(slot[i]);
+                slot[i] = slot.back();
+                slot.pop_back();
+                pending--;
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    // 가장 이른 만료 시각 (없으면 INT_MAX)
+    int next_expiry(int tick, const std::vector<ProcInfo>& p_table) const {
+        if (pending == 0) return INT_MAX;
+        for (int t = tick + 1; t <= tick + WHEEL_SLOTS; ++t) {
+            for (int idx : slots[t & (WHEEL_SLOTS - 1)]) {
+                if (p_table[idx].io_done == t) return t;
+            }
+        }
+        // 휠 한 바퀴보다 긴 I/O만 남은 경우 전체 검사
+        int earliest = INT_MAX;
+        for (const auto& slot : slots) {
+            for (int idx : slot) earliest = std::min(earliest, p_table[idx].io_done);
+        }
+        return earliest;
+    }
+};
+
+TimerWheel io_wheel;
+
+// 실행 옵션 (명령행 인자로 설정)
+bool virtual_time = false;      // 가상 시간 모드: 타이머 없이 최대 속도로 Tick 진행
+int sim_limit = SIM_LIMIT;      // 시뮬레이션 종료 시간 (Tick)
+
+// 3-1. IPC 전송 계층
+// 커널-자식 간 명령/응답을 SysV 메시지 큐 또는 공유 메모리 링으로 주고받음
+enum TransportKind {
+    TRANSPORT_MSGQ, // SysV 메시지 큐 (실행마다 IPC_PRIVATE 큐 1개를 자식들이 공유)
+    TRANSPORT_SHM,  // 자식별 공유 메모리 SPSC 링 + futex
+    TRANSPORT_INPROC, // fork/IPC 없이 커널 프로세스 안에서 자식 로직을 직접 호출
+    TRANSPORT_CORO    // 자식마다 C++20 코루틴 하나, 작업 스레드 풀에서 실행
+};
+
+// 단일 생산자/단일 소비자 링 버퍼 (fork 전에 공유 메모리에 생성)
+// head는 futex 대기 주소로도 사용됨
+struct alignas(64) SpscRing {
+    std::atomic<uint32_t> head;    // 생산자가 증가
+    std::atomic<uint32_t> waiters; // futex로 잠든 소비자 수
+    alignas(64) std::atomic<uint32_t> tail; // 소비자가 증가
+    struct { int command; int arg; } slots[RING_SLOTS];
+};
+
+// 자식 1개당 채널: 명령(커널 -> 자식), 응답(자식 -> 커널)
+struct ShmChannel {
+    SpscRing cmd;
+    SpscRing resp;
+};
+
+TransportKind transport = TRANSPORT_MSGQ;
+ShmChannel* shm_chan = nullptr; // 자식 수만큼의 채널 배열
+int spin_limit = 0;             // 호스트 코어가 1개면 busy-wait 없이 바로 futex 대기
+
+static void futex_wait(std::atomic<uint32_t>* addr, uint32_t expected) {
+    // 프로세스 간 공유 메모리이므로 PRIVATE 플래그를 쓰지 않음
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAIT, expected, NULL, NULL, 0);
+}
+
+static void futex_wake(std::atomic<uint32_t>* addr) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+void ring_push(SpscRing& r, int command, int arg) {
+    uint32_t h = r.head.load(std::memory_order_relaxed);
+    while (h - r.tail.load(std::memory_order_acquire) >= RING_SLOTS) sched_yield(); // 가득 참
+    r.slots[h % RING_SLOTS].command = command;
+    r.slots[h % RING_SLOTS].arg = arg;
+    r.head.store(h + 1, std::memory_order_seq_cst);
+    if (r.waiters.load(std::memory_order_seq_cst) > 0) futex_wake(&r.head);
+}
+
+int ring_pop(SpscRing& r, int* arg) {
+    uint32_t t = r.tail.load(std::memory_order_relaxed);
+    int spin = 0;
+    while (r.head.load(std::memory_order_acquire) == t) {
+        if (spin++ < spin_limit) continue;
+        // 생산자가 waiters를 확인하기 전에 잠들지 않도록 등록 후 다시 검사
+        r.waiters.fetch_add(1, std::memory_order_seq_cst);
+        if (r.head.load(std::memory_order_seq_cst) == t) futex_wait(&r.head, t);
+        r.waiters.fetch_sub(1, std::memory_order_seq_cst);
+    }
+    int command = r.slots[t % RING_SLOTS].command;
+    if (arg) *arg = r.slots[t % RING_SLOTS].arg;
+    r.tail.store(t + 1, std::memory_order_release);
+    return command;
+}
+
+bool setup_shm_channels(int count) {
+    void* mem = mmap(NULL, sizeof(ShmChannel) * count, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) { perror("mmap failed"); return false; }
+    shm_chan = new (mem) ShmChannel[count]();
+    spin_limit = (sysconf(_SC_NPROCESSORS_ONLN) > 1) ? SPIN_LIMIT : 0;
+    return true;
+}
+
+void release_shm_channels(int count) {
+    if (shm_chan) munmap(shm_chan, sizeof(ShmChannel) * count);
+    shm_chan = nullptr;
+}
+
+const char* transport_name(TransportKind kind) {
+    return kind == TRANSPORT_SHM ? "shm" : kind == TRANSPORT_INPROC ? "inproc" : kind == TRANSPORT_CORO ? "coro" : "msgq";
+}
+
+// 3-1-1. 코루틴 실행 (-T coro)
+// fork 대신 사용자 프로세스 하나를 코루틴 하나로 만들어 프로세스 수를 fork/메모리 한계 없이 늘림 (프로세스당 프레임 수백 바이트)
+// 커널이 명령을 보내면 코루틴을 작업 스레드 풀에 올리고, 코루틴은 같은 명령/응답 프로토콜로 응답한 뒤 다음 명령까지 중단됨
+// 응답은 코루틴이 완전히 중단된 뒤(await_suspend)에 공개하므로 커널이 아직 실행 중인 코루틴을 다시 깨우는 일이 없음
+enum CoroState : uint32_t { CORO_RUNNING, CORO_REPLIED };
+
+struct CoroChannel {
+    std::coroutine_handle<> handle; // 명령을 기다리며 중단된 코루틴
+    int command, arg;               // 커널 -> 코루틴
+    int resp, used;                 // 코루틴 -> 커널
+    std::atomic<uint32_t> state{CORO_REPLIED};
+};
+
+CoroChannel* coro_chan = nullptr; // 자식 수만큼의 채널 배열
+
+// 응답을 넘기고 다음 명령이 올 때까지 중단
+struct CoroReply {
+    CoroChannel* ch;
+    int resp, used;
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) const noexcept {
+        CoroChannel* c = ch; // 공개 이후에는 코루틴 프레임(이 객체 포함)을 건드리지 않음
+        c->handle = h;
+        c->resp = resp;
+        c->used = used;
+        c->state.store(CORO_REPLIED, std::memory_order_release);
+        c->state.notify_one();
+    }
+    void await_resume() const noexcept {}
+};
+
+// 사용자 프로세스 코루틴: 생성 직후 첫 명령을 기다리며 중단되고, 끝나면 종료를 응답으로 알림
+struct UserCoroutine {
+    struct promise_type {
+        CoroChannel* ch;
+        explicit promise_type(int idx) : ch(&coro_chan[idx]) {}
+        UserCoroutine get_return_object() { return {std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        CoroReply final_suspend() noexcept { return {ch, ParentCommand::CMD_TERMINATE, 0}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+    std::coroutine_handle<promise_type> handle;
+};
+
+// 코루틴을 실행하는 작업 스레드 풀 (공유 FIFO 큐)
+struct CoroPool {
+    std::vector<std::thread> workers;
+    std::mutex lock;
+    std::condition_variable ready;
+    std::deque<std::coroutine_handle<>> q;
+    bool stop = false;
+
+    void start(int threads) {
+        // SIGALRM(Tick 타이머)은 pause() 중인 커널 스레드만 받아야 함
+        sigset_t mask, old;
+        sigemptyset(&mask);
+        sigaddset(&mask, SIGALRM);
+        pthread_sigmask(SIG_BLOCK, &mask, &old);
+        stop = false;
+        for (int i = 0; i < threads; ++i) workers.emplace_back(&CoroPool::work, this);
+        pthread_sigmask(SIG_SETMASK, &old, NULL);
+    }
+
+    void post(std::coroutine_handle<> h) {
+        {
+            std::lock_guard<std::mutex> g(lock);
+            q.push_back(h);
+        }
+        ready.notify_one();
+    }
+
+    void work() {
+        while (true) {
+            std::unique_lock<std::mutex> g(lock);
+            ready.wait(g, [this] { return stop || !q.empty(); });
+            if (q.empty()) return;
+            std::coroutine_handle<> h = q.front();
+            q.pop_front();
+            g.unlock();
+            h.resume();
+        }
+    }
+
+    void finish() {
+        {
+            std::lock_guard<std::mutex> g(lock);
+            stop = true;
+        }
+        ready.notify_all();
+        for (auto& t : workers) t.join();
+        workers.clear();
+    }
+};
+
+CoroPool coro_pool;
+int coro_threads = 0; // 작업 스레드 수 (0이면 min(코어 수, 호스트 CPU 수))
+
+// 3-1-2. 워크로드 (CPU Burst / I/O 시간 / 커널의 남은 CPU 추정값)
+// random: 기존 rand() 방식, seed: 프로세스·항목별 독립 난수열, replay: 워크로드 파일 재생
+enum WorkloadMode { WL_RANDOM, WL_SEED, WL_REPLAY };
+
+enum WorkloadStream {
+    WS_BURST,    // 자식의 CPU Burst 길이
+    WS_IO,       // 자식의 I/O 요청 시간
+    WS_ESTIMATE, // 커널이 관리하는 남은 CPU 추정값
+    WS_COUNT
+};
+
+#define WORKLOAD_MAGIC "term1-workload"
+
+struct ProcWorkload {
+    uint64_t rng[WS_COUNT];             // seed 모드 난수 상태
+    std::vector<int> values[WS_COUNT];  // replay 모드 값 목록 (끝나면 처음부터 반복)
+};
+
+WorkloadMode workload_mode = WL_RANDOM;
+std::vector<ProcWorkload> workloads;
+// replay 모드 읽기 위치 ([idx * WS_COUNT + stream])
+// -n이 기록된 프로세스 수보다 커서 값 목록을 공유하더라도 위치는 프로세스마다 따로 두어
+// fork된 자식(각자 복사본)과 inproc/coro(커널 안의 한 벡터)가 같은 값을 읽음
+std::vector<size_t> replay_pos;
+
+static uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void seed_workloads(uint64_t seed, int count) {
+    workloads.assign(count, ProcWorkload());
+    for (int i = 0; i < count; ++i) {
+        for (int s = 0; s < WS_COUNT; ++s) {
+            uint64_t st = seed ^ ((uint64_t)i * 0x100000001B3ULL) ^ ((uint64_t)s << 56);
+            splitmix64(st);
+            workloads[i].rng[s] = st;
+        }
+    }
+}
+
+int next_workload_value(int idx, WorkloadStream stream) {
+    static const int base[WS_COUNT] = {1, 5, 1}; // 기존 rand() % 10 + base 범위와 같음
+    if (workload_mode == WL_RANDOM) return (rand() % 10) + base[stream];
+
+    ProcWorkload& w = workloads[idx % workloads.size()];
+    if (workload_mode == WL_SEED) return (int)(splitmix64(w.rng[stream]) % 10) + base[stream];
+
+    const std::vector<int>& v = w.values[stream];
+    if (v.empty()) return base[stream];
+    return v[replay_pos[(size_t)idx * WS_COUNT + stream]++ % v.size()];
+}
+
+// 워크로드 파일 형식 (텍스트)
+//   term1-workload 1 <프로세스 수>
+//   B <idx> <CPU Burst...>
+//   I <idx> <I/O 시간...>
+//   E <idx> <남은 CPU 추정값...>
+int load_workload(const char* path) {
+    std::ifstream in(path);
+    std::string magic;
+    int version = 0, procs = 0;
+    if (!(in >> magic >> version >> procs) || magic != WORKLOAD_MAGIC || procs <= 0) {
+        fprintf(stderr, "%s: not a term1 workload file\n", path);
+        return -1;
+    }
+    workloads.assign(procs, ProcWorkload());
+
+    std::string line;
+    std::getline(in, line);
+    while (std::getline(in, line)) {
+        std::istringstream ls(line);
+        char kind;
+        int idx, v;
+        if (!(ls >> kind >> idx) || idx < 0 || idx >= procs) continue;
+        int stream = (kind == 'B') ? WS_BURST : (kind == 'I') ? WS_IO : (kind == 'E') ? WS_ESTIMATE : -1;
+        if (stream < 0) continue;
+        while (ls >> v) workloads[idx].values[stream].push_back(v);
+    }
+    workload_mode = WL_REPLAY;
+    return procs;
+}
+
+// 실행 중 관측한 워크로드 기록 (커널 쪽에서 관측 가능한 값만으로 재구성)
+// 자식의 CPU Burst = I/O 요청 사이에 실행한 Tick 수, I/O 시간 = 응답값
+struct WorkloadRecorder {
+    bool enabled = false;
+    std::vector<std::vector<int>> values[WS_COUNT];
+    std::vector<int> burst_progress; // 현재 Burst에서 실행한 Tick 수
+
+    void start(int count) {
+        enabled = true;
+        for (auto& v : values) v.assign(count, std::vector<int>());
+        burst_progress.assign(count, 0);
+    }
+    void add(int idx, WorkloadStream stream, int value) {
+        if (enabled) values[stream][idx].push_back(value);
+    }
+    void on_tick(int idx, int io_duration) {
+        if (!enabled) return;
+        burst_progress[idx]++;
+        if (io_duration > 0) {
+            add(idx, WS_BURST, burst_progress[idx]);
+            add(idx, WS_IO, io_duration);
+            burst_progress[idx] = 0;
+        }
+    }
+    bool save(const char* path) {
+        FILE* fp = fopen(path, "w");
+        if (!fp) { perror("workload file open failed"); return false; }
+        int count = burst_progress.size();
+        fprintf(fp, "%s 1 %d\n", WORKLOAD_MAGIC, count);
+        static const char kinds[WS_COUNT] = {'B', 'I', 'E'};
+        for (int i = 0; i < count; ++i) {
+            // 끝나지 않은 Burst는 지금까지 실행한 Tick보다 길다는 것만 알 수 있으므로 +1로 기록
+            if (burst_progress[i] > 0) values[WS_BURST][i].push_back(burst_progress[i] + 1);
+            for (int s = 0; s < WS_COUNT; ++s) {
+                fprintf(fp, "%c %d", kinds[s], i);
+                for (int v : values[s][i]) fprintf(fp, " %d", v);
+                fprintf(fp, "\n");
+            }
+        }
+        fclose(fp);
+        return true;
+    }
+};
+
+WorkloadRecorder recorder;
+
+// 커널이 관리하는 남은 CPU 추정값
+int next_cpu_estimate(int idx) {
+    int v = next_workload_value(idx, WS_ESTIMATE);
+    recorder.add(idx, WS_ESTIMATE, v);
+    return v;
+}
+
+// 자식 프로세스의 실행 상태 (fork된 자식과 in-process 실행이 같은 로직을 사용)
+struct UserProc {
+    int cpu_burst;      // 남은 CPU Burst
+    int pending_cmd;    // in-process 모드: 아직 처리하지 않은 명령
+    int pending_arg;
+};
+
+std::vector<UserProc> inproc_users;
+int user_execute(UserProc& u, int idx, int command, int arg, int* used);
+
+// 커널 -> 자식 명령 전송
+void send_command(int idx, pid_t pid, int cmd, int arg = 0) {
+    if (transport == TRANSPORT_CORO) {
+        CoroChannel& ch = coro_chan[idx];
+        ch.command = cmd;
+        ch.arg = arg;
+        ch.state.store(CORO_RUNNING, std::memory_order_relaxed);
+        coro_pool.post(ch.handle);
+        return;
+    }
+    if (transport == TRANSPORT_INPROC) {
+        inproc_users[idx].pending_cmd = cmd;
+        inproc_users[idx].pending_arg = arg;
+        return;
+    }
+    if (transport == TRANSPORT_SHM) {
+        ring_push(shm_chan[idx].cmd, cmd, arg);
+        return;
+    }
+    IpcMsg pkt;
+    pkt.mtype = pid;
+    pkt.command = cmd;
+    pkt.arg = arg;
+    while (msgsnd(mq_id, &pkt, IPC_MSG_SIZE, 0) == -1 && errno == EINTR) {}
+}
+
+// 자식 -> 커널 응답 수신
+// 여러 코어의 자식이 동시에 응답하므로 자식별 메시지 타입(RESP_MTYPE_BASE + PID)으로 구분함
+int recv_response(int idx, pid_t pid, int* arg = nullptr) {
+    if (transport == TRANSPORT_INPROC) {
+        UserProc& u = inproc_users[idx];
+        int used = 0;
+        int resp = user_execute(u, idx, u.pending_cmd, u.pending_arg, &used);
+        if (arg) *arg = used;
+        return resp;
+    }
+    if (transport == TRANSPORT_SHM) return ring_pop(shm_chan[idx].resp, arg);
+    if (transport == TRANSPORT_CORO) {
+        CoroChannel& ch = coro_chan[idx];
+        for (int spin = 0; ch.state.load(std::memory_order_acquire) != CORO_REPLIED; ) {
+            if (spin++ >= spin_limit) ch.state.wait(CORO_RUNNING, std::memory_order_acquire);
+        }
+        if (arg) *arg = ch.used;
+        return ch.resp;
+    }
+
+    IpcMsg pkt;
+    while (msgrcv(mq_id, &pkt, IPC_MSG_SIZE, RESP_MTYPE_BASE + pid, 0) == -1) {
+        if (errno != EINTR) { perror("msgrcv failed"); exit(1); }
+    }
+    if (arg) *arg = pkt.arg;
+    return pkt.command;
+}
+
+// 3-2. 스케줄링 정책
+// Ready 상태 프로세스의 관리와 다음 실행 프로세스 선택을 정책별로 분리함
+enum EnqueueReason {
+    ENQ_NEW,        // 최초 생성
+    ENQ_WAKEUP,     // I/O 완료
+    ENQ_EXPIRED,    // Time Quantum 만료
+    ENQ_PREEMPTED,  // 우선순위가 더 높은 프로세스에 의해 선점
+    ENQ_MIGRATED    // 다른 코어의 Run Queue에서 옮겨옴 (Work Stealing)
+};
+
+class Scheduler {
+public:
+    virtual ~Scheduler() {}
+    virtual const char* name() const = 0;
+    virtual void enqueue(ProcInfo& p, EnqueueReason why) = 0;
+    virtual pid_t pick_next() = 0;                          // 다음 실행 프로세스를 꺼냄 (없으면 -1)
+    virtual pid_t steal() = 0;                              // 가장 늦게 실행될 프로세스를 꺼냄 (없으면 -1)
+    virtual int time_slice(const ProcInfo& p) const = 0;    // Dispatch 시 할당할 Quantum
+    virtual bool should_preempt(const ProcInfo& running) const { return false; }
+    // 새 Ready 프로세스가 없을 때 선점 없이 연속 실행할 수 있는 Tick 수 (배치 실행 길이 결정용)
+    virtual int run_ahead(const ProcInfo& running) const { return INT_MAX; }
+    virtual bool preempts_on_wakeup() const { return false; }       // I/O 완료가 선점을 일으킬 수 있는지
+    virtual void on_run_tick(ProcInfo& p) {}                // 실행 중인 프로세스가 1 Tick 소비
+    virtual void on_system_tick(int tick, std::vector<ProcInfo>& p_table) {}
+    // tick 이후 on_system_tick이 상태를 바꾸는 가장 가까운 Tick (유휴 구간 건너뛰기가 넘지 않도록)
+    virtual int next_event_tick(int tick) const { return INT_MAX; }
+    virtual size_t size() const = 0;
+    virtual void snapshot(std::vector<pid_t>& out) const = 0; // 로그 출력용 (실행 예정 순서)
+};
+
+// Round-Robin: FIFO 큐, 고정 Quantum
+class RRScheduler : public Scheduler {
+    std::deque<pid_t> q;
+public:
+    const char* name() const override { return "rr"; }
+    void enqueue(ProcInfo& p, EnqueueReason why) override { q.push_back(p.pid); }
+    pid_t pick_next() override {
+        if (q.empty()) return -1;
+        pid_t pid = q.front();
+        q.pop_front();
+        return pid;
+    }
+    pid_t steal() override {
+        if (q.empty()) return -1;
+        pid_t pid = q.back();
+        q.pop_back();
+        return pid;
+    }
+    int time_slice(const ProcInfo& p) const override { return t_quantum; }
+    size_t size() const override { return q.size(); }
+    void snapshot(std::vector<pid_t>& out) const override { out.assign(q.begin(), q.end()); }
+};
+
+// MLFQ: Quantum을 다 쓰면 한 단계 강등, 주기적으로 전체를 최상위 단계로 올림
+class MLFQScheduler : public Scheduler {
+    std::deque<pid_t> q[MLFQ_LEVELS];
+    size_t count = 0;
+public:
+    const char* name() const override { return "mlfq"; }
+    void enqueue(ProcInfo& p, EnqueueReason why) override {
+        if (why == ENQ_NEW) p.mlfq_level = 0;
+        else if (why == ENQ_EXPIRED && p.mlfq_level < MLFQ_LEVELS - 1) p.mlfq_level++;
+        q[p.mlfq_level].push_back(p.pid);
+        count++;
+    }
+    pid_t pick_next() override {
+        for (auto& level : q) {
+            if (level.empty()) continue;
+            pid_t pid = level.front();
+            level.pop_front();
+            count--;
+            return pid;
+        }
+        return -1;
+    }
+    pid_t steal() override {
+        for (int lv = MLFQ_LEVELS - 1; lv >= 0; --lv) {
+            if (q[lv].empty()) continue;
+            pid_t pid = q[lv].back();
+            q[lv].pop_back();
+            count--;
+            return pid;
+        }
+        return -1;
+    }
+    int time_slice(const ProcInfo& p) const override { return t_quantum << p.mlfq_level; }
+    bool should_preempt(const ProcInfo& running) const override {
+        for (int lv = 0; lv < running.mlfq_level; ++lv) {
+            if (!q[lv].empty()) return true;
+        }
+        return false;
+    }
+    bool preempts_on_wakeup() const override { return true; }
+    void on_system_tick(int tick, std::vector<ProcInfo>& p_table) override {
+        if (tick % MLFQ_BOOST != 0) return;
+        // Priority Boost: 하위 단계 큐를 순서대로 최상위 단계 뒤에 붙임
+        for (int lv = 1; lv < MLFQ_LEVELS; ++lv) {
+            q[0].insert(q[0].end(), q[lv].begin(), q[lv].end());
+            q[lv].clear();
+        }
+        for (auto& p : p_table) p.mlfq_level = 0;
+    }
+    int next_event_tick(int tick) const override { return (tick / MLFQ_BOOST + 1) * MLFQ_BOOST; }
+    size_t size() const override { return count; }
+    void snapshot(std::vector<pid_t>& out) const override {
+        out.clear();
+        for (const auto& level : q) out.insert(out.end(), level.begin(), level.end());
+    }
+};
+
+// SJF / SRTF: 남은 CPU Burst가 가장 짧은 프로세스 우선 (이진 힙)
+// SRTF는 더 짧은 프로세스가 Ready가 되면 실행 중인 프로세스를 선점함
+class SJFScheduler : public Scheduler {
+    struct Entry { int cpu_time; long seq; pid_t pid; };
+    struct Longer {
+        bool operator()(const Entry& a, const Entry& b) const {
+            return a.cpu_time != b.cpu_time ? a.cpu_time > b.cpu_time : a.seq > b.seq;
+        }
+    };
+    std::vector<Entry> heap;
+    long seq = 0;
+    bool preemptive;
+public:
+    explicit SJFScheduler(bool srtf) : preemptive(srtf) {}
+    const char* name() const override { return preemptive ? "srtf" : "sjf"; }
+    void enqueue(ProcInfo& p, EnqueueReason why) override {
+        heap.push_back({p.cpu_time, seq++, p.pid});
+        std::push_heap(heap.begin(), heap.end(), Longer());
+    }
+    pid_t pick_next() override {
+        if (heap.empty()) return -1;
+        std::pop_heap(heap.begin(), heap.end(), Longer());
+        pid_t pid = heap.back().pid;
+        heap.pop_back();
+        return pid;
+    }
+    pid_t steal() override {
+        // 가장 늦게 실행될 원소(남은 CPU가 가장 긴 것)는 항상 리프이므로 뒤쪽 절반만 탐색
+        if (heap.empty()) return -1;
+        size_t last = heap.size() / 2;
+        for (size_t i = last + 1; i < heap.size(); i++)
+            if (Longer()(heap[i], heap[last])) last = i;
+        pid_t pid = heap[last].pid;
+        // 빈 자리를 마지막 원소로 채우고 위로 올려 힙 속성 복구
+        heap[last] = heap.back();
+        heap.pop_back();
+        if (last < heap.size()) std::push_heap(heap.begin(), heap.begin() + last + 1, Longer());
+        return pid;
+    }
+    int time_slice(const ProcInfo& p) const override { return INT_MAX; } // I/O 요청까지 실행
+    bool should_preempt(const ProcInfo& running) const override {
+        return preemptive && !heap.empty() && heap.front().cpu_time < running.cpu_time;
+    }
+    // 남은 CPU가 0이 되어 재설정되기 전까지는 더 짧아질 뿐이므로 선점되지 않음
+    int run_ahead(const ProcInfo& running) const override { return preemptive ? std::max(1, running.cpu_time) : INT_MAX; }
+    bool preempts_on_wakeup() const override { return preemptive; }
+    size_t size() const override { return heap.size(); }
+    void snapshot(std::vector<pid_t>& out) const override {
+        std::vector<Entry> sorted(heap);
+        std::sort(sorted.begin(), sorted.end(), [](const Entry& a, const Entry& b) { return Longer()(b, a); });
+        out.clear();
+        for (const auto& e : sorted) out.push_back(e.pid);
+    }
+};
+
+// CFS: vruntime이 가장 작은 프로세스 우선 (std::set = Red-Black Tree)
+class CFSScheduler : public Scheduler {
+    struct Entry {
+        long vruntime; long seq; pid_t pid;
+        bool operator<(const Entry& o) const { return vruntime != o.vruntime ? vruntime < o.vruntime : seq < o.seq; }
+    };
+    std::set<Entry> tree;
+    long min_vruntime = 0;
+    long seq = 0;
+public:
+    const char* name() const override { return "cfs"; }
+    void enqueue(ProcInfo& p, EnqueueReason why) override {
+        // 새로 생성되거나 깨어나거나 옮겨온 프로세스는 min_vruntime 근처에서 시작 (독점 방지)
+        if (why == ENQ_NEW || why == ENQ_WAKEUP || why == ENQ_MIGRATED) p.vruntime = std::max(p.vruntime, min_vruntime - CFS_LATENCY / 2);
+        tree.insert({p.vruntime, seq++, p.pid});
+    }
+    pid_t pick_next() override {
+        if (tree.empty()) return -1;
+        auto it = tree.begin();
+        min_vruntime = std::max(min_vruntime, it->vruntime);
+        pid_t pid = it->pid;
+        tree.erase(it);
+        return pid;
+    }
+    pid_t steal() override {
+        if (tree.empty()) return -1;
+        auto it = std::prev(tree.end());
+        pid_t pid = it->pid;
+        tree.erase(it);
+        return pid;
+    }
+    int time_slice(const ProcInfo& p) const override {
+        return std::max(CFS_MIN_GRAN, CFS_LATENCY / (int)(tree.size() + 1));
+    }
+    bool should_preempt(const ProcInfo& running) const override {
+        return !tree.empty() && tree.begin()->vruntime + CFS_WAKEUP_GRAN < running.vruntime;
+    }
+    // 실행 중인 vruntime이 Tick마다 1씩 늘어 leftmost + CFS_WAKEUP_GRAN을 넘기 전까지
+    int run_ahead(const ProcInfo& running) const override {
+        if (tree.empty()) return INT_MAX;
+        return (int)std::max(1L, tree.begin()->vruntime + CFS_WAKEUP_GRAN - running.vruntime + 1);
+    }
+    bool preempts_on_wakeup() const override { return true; }
+    void on_run_tick(ProcInfo& p) override { p.vruntime++; }
+    size_t size() const override { return tree.size(); }
+    void snapshot(std::vector<pid_t>& out) const override {
+        out.clear();
+        for (const auto& e : tree) out.push_back(e.pid);
+    }
+};
+
+Scheduler* make_scheduler(const char* name) {
+    if (strcmp(name, "rr") == 0) return new RRScheduler();
+    if (strcmp(name, "mlfq") == 0) return new MLFQScheduler();
+    if (strcmp(name, "sjf") == 0) return new SJFScheduler(false);
+    if (strcmp(name, "srtf") == 0) return new SJFScheduler(true);
+    if (strcmp(name, "cfs") == 0) return new CFSScheduler();
+    return nullptr;
+}
+
+ProcInfo* find_proc(std::vector<ProcInfo>& p_table, pid_t pid) {
+    auto it = pid_index.find(pid);
+    return it != pid_index.end() ? &p_table[it->second] : nullptr;
+}
+
+// 시뮬레이션 CPU 코어 (코어마다 독립된 Run Queue를 가짐)
+struct CpuCore {
+    Scheduler* rq = nullptr;    // 코어별 Run Queue
+    pid_t running_pid = -1;     // 현재 실행 중인 프로세스 ID
+    int q_counter = 0;          // 현재 프로세스의 남은 Time Quantum
+    ProcInfo* curr = nullptr;   // 이번 Tick에 실행한 프로세스 (로그용)
+    long busy_ticks = 0;        // 프로세스를 실행한 Tick 수
+    long dispatches = 0;
+    long steals = 0;            // 다른 코어에서 훔쳐온 횟수
+    int batch_left = 0;         // 배치로 이미 실행됐지만 아직 재구성하지 않은 Tick 수
+    int batch_resp = 0;         // 배치 응답 (마지막 Tick에 반영)
+    pid_t last_pid = -1;        // 직전에 실행한 프로세스 (Context Switch 판단용)
+    struct timespec sent_at;    // 실행 명령 전송 시각 (왕복 지연 측정용)
+};
+
+int cpu_count = 1;
+std::vector<CpuCore> cores;
+
+// Ready 상태로 전환 (대기 시간 측정 시작, 소속 코어의 Run Queue에 넣음)
+void make_ready(ProcInfo& p, EnqueueReason why) {
+    p.ready_since = sys_tick;
+    if (why == ENQ_NEW || why == ENQ_WAKEUP) {
+        p.burst_start = sys_tick;
+        p.responded = false;
+    }
+    cores[p.cpu].rq->enqueue(p, why);
+}
+
+size_t total_ready() {
+    size_t n = 0;
+    for (const auto& c : cores) n += c.rq->size();
+    return n;
+}
 
 // 4. 로깅 함수
-// 현재 시스템 상태(실행 중인 프로세스, Ready/Wait 큐)를 파일, 콘솔에 기록함
-void write_log(FILE* fp, int tick, ProcInfo* running_proc, std::deque<pid_t>& r_q, const std::vector<ProcInfo>& p_table) {
-    char header_buf[256];
-    snprintf(header_buf, sizeof(header_buf), "\n--- Time Tick T: %d ---\n", tick);
-    printf("%s", header_buf);
-    fprintf(fp, "%s", header_buf);
-    
-    // Running Process 정보 출력
-    printf("[ Running Process ]\n");
-    fprintf(fp, "[ Running Process ]\n");
-    if (running_proc) {
-        printf("PID: %-5d | Remaining CPU: %-5d | Time Quantum Left: %d\n", running_proc->pid, running_proc->cpu_time, q_counter);
-        fprintf(fp, "PID: %-5d | Remaining CPU: %-5d | Time Quantum Left: %d\n", running_proc->pid, running_proc->cpu_time, q_counter);
-    } else {
-        printf("IDLE (CPU 쉬는 중)\n");
-        fprintf(fp, "IDLE (CPU 쉬는 중)\n");
+// 한 Tick의 상태를 고정 크기 레코드 묶음으로 만든 뒤, 텍스트로 렌더링하거나 바이너리로 그대로 기록함
+// (텍스트 로그와 --decode 결과가 같은 렌더러를 거치므로 형식이 항상 동일함)
+enum LogMode {
+    LOG_TEXT,   // schedule_dump.txt (기본값)
+    LOG_BINARY, // schedule_dump.bin (백그라운드 스레드가 기록)
+    LOG_NONE    // 파일 기록 안 함
+};
+
+enum TraceType {
+    REC_TICK = 1,   // a=tick, b=Ready 수, c=Wait 수
+    REC_RUN,        // a=pid, b=남은 CPU, c=남은 Quantum (cpu=코어 번호)
+    REC_IDLE,       // 실행 중인 프로세스 없음 (cpu=코어 번호)
+    REC_READY,      // a=pid, b=남은 CPU (cpu=소속 코어 번호)
+    REC_WAIT,       // a=pid, b=남은 I/O, c=다음 CPU Burst
+    REC_SKIP        // a~b Tick 유휴 구간 생략
+};
+
+struct TraceRec {
+    uint8_t type;
+    uint8_t cpu;        // 멀티 코어 모드의 코어 번호 (단일 코어는 항상 0)
+    uint8_t reserved[2];
+    int32_t a, b, c;
+};
+
+#define TRACE_MAGIC "T1TRACE1"
+#define TRACE_RING_SIZE (1 << 16) // 백그라운드 기록용 링 버퍼 크기 (레코드 수, 2의 거듭제곱)
+
+LogMode log_mode = LOG_TEXT;
+bool quiet = false;             // 콘솔 출력 생략
+
+// 단일 생산자(스케줄러)/단일 소비자(기록 스레드) 링 버퍼
+struct TraceWriter {
+    TraceRec* buf = nullptr;
+    std::atomic<size_t> head{0};
+    std::atomic<size_t> tail{0};
+    std::atomic<bool> stop{false};
+    FILE* fp = nullptr;
+    std::thread worker;
+
+    void start(FILE* out) {
+        fp = out;
+        buf = new TraceRec[TRACE_RING_SIZE];
+        fwrite(TRACE_MAGIC, 1, 8, fp);
+        worker = std::thread(&TraceWriter::drain, this);
     }
 
-    // Ready Queue 정보 출력
-    printf("\n[ Ready Queue: %zu Processes ]\n", r_q.size());
-    fprintf(fp, "\n[ Ready Queue: %zu Processes ]\n", r_q.size());
-    printf("%-10s | %-10s | %-10s\n", "PID", "CPU Left", "Wait Status");
-    fprintf(fp, "%-10s | %-10s | %-10s\n", "PID", "CPU Left", "Wait Status");
-    printf("----------------------------------\n");
-    fprintf(fp, "----------------------------------\n");
-
-    for (pid_t pid : r_q) {
-        const ProcInfo* p = nullptr;
-        for (const auto& proc : p_table) {
-            if (proc.pid == pid) {
-                p = &proc;
-                break;
+    void push(const TraceRec* recs, size_t n) {
+        size_t h = head.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < n; ++i) {
+            while (h - tail.load(std::memory_order_acquire) >= TRACE_RING_SIZE) {
+                head.store(h, std::memory_order_release); // 가득 차면 지금까지 쓴 것을 먼저 넘김
+                sched_yield();
             }
+            buf[h & (TRACE_RING_SIZE - 1)] = recs[i];
+            h++;
         }
-        if (p) {
-            printf("%-10d | %-10d | %-10s\n", p->pid, p->cpu_time, "READY");
-            fprintf(fp, "%-10d | %-10d | %-10s\n", p->pid, p->cpu_time, "READY");
+        head.store(h, std::memory_order_release);
+    }
+
+    void drain() {
+        while (true) {
+            size_t t = tail.load(std::memory_order_relaxed);
+            size_t h = head.load(std::memory_order_acquire);
+            if (h == t) {
+                if (stop.load(std::memory_order_acquire) && head.load(std::memory_order_acquire) == t) break;
+                usleep(500);
+                continue;
+            }
+            // 링 경계를 넘지 않는 연속 구간 단위로 기록
+            size_t begin = t & (TRACE_RING_SIZE - 1);
+            size_t len = std::min(h - t, TRACE_RING_SIZE - begin);
+            fwrite(&buf[begin], sizeof(TraceRec), len, fp);
+            tail.store(t + len, std::memory_order_release);
         }
     }
-    
+
+    void finish() {
+        stop.store(true, std::memory_order_release);
+        if (worker.joinable()) worker.join();
+        delete[] buf;
+        buf = nullptr;
+    }
+};
+
+TraceWriter trace_writer;
+
+static void append_fmt(std::string& out, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+static void append_fmt(std::string& out, const char* fmt, ...) {
+    char line[256];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(line, sizeof(line), fmt, ap);
+    va_end(ap);
+    out.append(line, std::min(n, (int)sizeof(line) - 1));
+}
+
+// 레코드 -> 텍스트 (REC_TICK으로 시작하는 한 Tick 분량 또는 REC_SKIP 한 개)
+void render_records(const TraceRec* r, size_t n, std::string& out) {
+    if (n == 0) return;
+    if (r[0].type == REC_SKIP) {
+        append_fmt(out, "\n--- Time Tick T: %d ~ %d (IDLE 구간 생략) ---\n", r[0].a, r[0].b);
+        return;
+    }
+
+    append_fmt(out, "\n--- Time Tick T: %d ---\n", r[0].a);
+
+    // 코어가 여러 개면 코어 번호를 함께 출력 (단일 코어 로그 형식은 그대로 유지)
+    size_t run_recs = 0;
+    for (size_t i = 1; i < n; ++i) {
+        if (r[i].type == REC_RUN || r[i].type == REC_IDLE) run_recs++;
+    }
+    bool multi = run_recs > 1;
+
+    // Running Process 정보 출력
+    out += "[ Running Process ]\n";
+    for (size_t i = 1; i < n; ++i) {
+        if (r[i].type != REC_RUN && r[i].type != REC_IDLE) continue;
+        if (multi) append_fmt(out, "CPU %-3d | ", r[i].cpu);
+        if (r[i].type == REC_RUN) {
+            append_fmt(out, "PID: %-5d | Remaining CPU: %-5d | Time Quantum Left: %d\n", r[i].a, r[i].b, r[i].c);
+        } else {
+            out += "IDLE (CPU 쉬는 중)\n";
+        }
+    }
+
+    // Ready Queue 정보 출력
+    append_fmt(out, "\n[ Ready Queue: %d Processes ]\n", r[0].b);
+    append_fmt(out, "%-10s | %-10s | %-10s\n", "PID", "CPU Left", "Wait Status");
+    out += "----------------------------------\n";
+    for (size_t i = 1; i < n; ++i) {
+        if (r[i].type != REC_READY) continue;
+        if (multi) append_fmt(out, "%-10d | %-10d | READY@CPU%d\n", r[i].a, r[i].b, r[i].cpu);
+        else append_fmt(out, "%-10d | %-10d | %-10s\n", r[i].a, r[i].b, "READY");
+    }
+
     // Wait Queue 정보 출력
-    printf("\n[ Wait Queue (I/O): %zu Processes ]\n", std::count_if(p_table.begin(), p_table.end(), [](const ProcInfo& p){ return p.is_waiting; }));
-    fprintf(fp, "\n[ Wait Queue (I/O): %zu Processes ]\n", std::count_if(p_table.begin(), p_table.end(), [](const ProcInfo& p){ return p.is_waiting; }));
-    printf("%-10s | %-10s | %-10s\n", "PID", "I/O Left", "CPU Next");
-    fprintf(fp, "%-10s | %-10s | %-10s\n", "PID", "I/O Left", "CPU Next");
-    printf("----------------------------------\n");
-    fprintf(fp, "----------------------------------\n");
+    append_fmt(out, "\n[ Wait Queue (I/O): %d Processes ]\n", r[0].c);
+    append_fmt(out, "%-10s | %-10s | %-10s\n", "PID", "I/O Left", "CPU Next");
+    out += "----------------------------------\n";
+    for (size_t i = 1; i < n; ++i) {
+        if (r[i].type == REC_WAIT) append_fmt(out, "%-10d | %-10d | %-10d\n", r[i].a, r[i].b, r[i].c);
+    }
+}
+
+// 로그 출력: 콘솔(quiet가 아니면) + 로그 파일(log_mode)
+void emit_records(FILE* fp, const std::vector<TraceRec>& recs) {
+    if (log_mode == LOG_BINARY) trace_writer.push(recs.data(), recs.size());
+    if (quiet && log_mode != LOG_TEXT) return;
+
+    static std::string text;
+    text.clear();
+    render_records(recs.data(), recs.size(), text);
+    if (!quiet) fwrite(text.data(), 1, text.size(), stdout);
+    if (log_mode == LOG_TEXT) fwrite(text.data(), 1, text.size(), fp);
+}
+
+// 현재 시스템 상태(실행 중인 프로세스, Ready/Wait 큐)를 파일, 콘솔에 기록함
+void write_log(FILE* fp, int tick, const std::vector<ProcInfo>& p_table) {
+    if (quiet && log_mode == LOG_NONE) return;
 
+    static std::vector<TraceRec> recs;
+    static std::vector<pid_t> r_q;
+    recs.clear();
+    recs.push_back({REC_TICK, 0, {}, tick, (int32_t)total_ready(), (int32_t)io_wheel.pending});
+
+    // Running Process 정보
+    for (int c = 0; c < cpu_count; ++c) {
+        const ProcInfo* running_proc = cores[c].curr;
+        if (running_proc) recs.push_back({REC_RUN, (uint8_t)c, {}, running_proc->pid, running_proc->cpu_time, cores[c].q_counter});
+        else recs.push_back({REC_IDLE, (uint8_t)c, {}, 0, 0, 0});
+    }
+
+    // Ready Queue 정보 (코어 순서대로, 각 코어 안에서는 실행 예정 순서)
+    for (int c = 0; c < cpu_count; ++c) {
+        cores[c].rq->snapshot(r_q);
+        for (pid_t pid : r_q) {
+            auto it = pid_index.find(pid);
+            const ProcInfo* p = (it != pid_index.end()) ? &p_table[it->second] : nullptr;
+            if (p) recs.push_back({REC_READY, (uint8_t)c, {}, p->pid, p->cpu_time, 0});
+        }
+    }
+
+    // Wait Queue 정보
     for (const auto& p : p_table) {
-        if (p.is_waiting) {
-            printf("%-10d | %-10d | %-10d\n", p.pid, p.io_time, p.cpu_time);
-            fprintf(fp, "%-10d | %-10d | %-10d\n", p.pid, p.io_time, p.cpu_time);
+        if (p.is_waiting) recs.push_back({REC_WAIT, 0, {}, p.pid, p.io_done - tick, p.cpu_time});
+    }
+
+    emit_records(fp, recs);
+}
+
+// 유휴 구간 생략 로그 (가상 시간 모드에서 건너뛴 Tick 범위를 한 줄로 기록)
+void write_idle_log(FILE* fp, int from_tick, int to_tick) {
+    std::vector<TraceRec> recs(1, TraceRec{REC_SKIP, 0, {}, from_tick, to_tick, 0});
+    emit_records(fp, recs);
+}
+
+// 바이너리 로그 -> 텍스트 변환 (schedule_dump.txt와 같은 형식으로 stdout에 출력)
+int decode_trace(const char* path) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) { perror("file open failed"); return 1; }
+
+    char magic[8];
+    if (fread(magic, 1, 8, fp) != 8 || memcmp(magic, TRACE_MAGIC, 8) != 0) {
+        fprintf(stderr, "%s: not a term1 binary trace\n", path);
+        fclose(fp);
+        return 1;
+    }
+
+    std::vector<TraceRec> chunk(4096);
+    std::vector<TraceRec> group; // REC_TICK부터 다음 REC_TICK/REC_SKIP 전까지
+    std::string text;
+    auto flush_group = [&]() {
+        if (group.empty()) return;
+        text.clear();
+        render_records(group.data(), group.size(), text);
+        fwrite(text.data(), 1, text.size(), stdout);
+        group.clear();
+    };
+
+    size_t n;
+    while ((n = fread(chunk.data(), sizeof(TraceRec), chunk.size(), fp)) > 0) {
+        for (size_t i = 0; i < n; ++i) {
+            if (chunk[i].type == REC_TICK || chunk[i].type == REC_SKIP) flush_group();
+            group.push_back(chunk[i]);
         }
     }
+    flush_group();
+    fclose(fp);
+    return 0;
 }
 
 // 5. 시그널 핸들러
@@ -117,190 +1107,1031 @@ void on_timer_tick(int signum) {
 }
 
 // 6. 자식 프로세스 
-void run_user_process() {
-    srand(getpid() * time(NULL));
-    int my_cpu_burst = (rand() % 10) + 1;
+// 스케줄러 명령 대기 (Blocking)
+int child_recv_command(int idx, int* arg) {
+    if (transport == TRANSPORT_SHM) return ring_pop(shm_chan[idx].cmd, arg);
+
+    IpcMsg pkt;
+    if (msgrcv(mq_id, &pkt, IPC_MSG_SIZE, getpid(), 0) == -1) {
+        if (errno != EIDRM) perror("msgrcv failed");
+        exit(0);
+    }
+    *arg = pkt.arg;
+    return pkt.command;
+}
+
+// 스케줄러에게 응답 전송
+void child_send_response(int idx, int resp, int ticks) {
+    if (transport == TRANSPORT_SHM) {
+        ring_push(shm_chan[idx].resp, resp, ticks);
+        return;
+    }
     IpcMsg pkt;
+    pkt.mtype = RESP_MTYPE_BASE + getpid();
+    pkt.command = resp;
+    pkt.arg = ticks;
+    if (msgsnd(mq_id, &pkt, IPC_MSG_SIZE, 0) == -1) {
+        perror("msgsnd failed");
+        exit(1);
+    }
+}
 
-    while (1) {
-        // 스케줄러 명령 대기 (Blocking)
-        if (msgrcv(mq_id, &pkt, sizeof(int), getpid(), 0) == -1) {
-            if (errno != EIDRM) perror("msgrcv failed");
-            exit(0);
-        }
-        
-        // 종료 명령 수신 시 루프를 탈출하게끔
-        if (pkt.command == ParentCommand::CMD_TERMINATE) break;
+// 명령 1개 처리: 최대 limit Tick을 실행하고 응답값을 반환 (*used = 실제 실행한 Tick 수)
+int user_execute(UserProc& u, int idx, int command, int arg, int* used) {
+    // 배치 명령이면 Quantum 만료 또는 I/O 요청까지 여러 Tick을 연속 실행
+    int limit = (command == ParentCommand::CMD_EXECUTE_BATCH) ? arg : 1;
+    int resp = ChildResponse::RESP_TICK_DONE; // 작업 미완료 (Tick 소진)
+    *used = 0;
 
+    while (*used < limit) {
         // 1 tick 작업 수행
-        my_cpu_burst--;
-        
-        pkt.mtype = getppid(); 
+        u.cpu_burst--;
+        (*used)++;
 
         // CPU 작업 완료 여부 확인
-        if (my_cpu_burst <= 0) {
+        if (u.cpu_burst <= 0) {
             // I/O 작업 요청
-            int io_duration = (rand() % 10) + 5;
-            pkt.command = io_duration;           
-            my_cpu_burst = (rand() % 10) + 1;    
+            int io_duration = next_workload_value(idx, WS_IO);
+            resp = io_duration;           
+            u.cpu_burst = next_workload_value(idx, WS_BURST);
+            break;
         } 
-        else {
-            // 작업 미완료 (Tick 소진)
-            pkt.command = ChildResponse::RESP_TICK_DONE; 
-        }
+    }
+    return resp;
+}
 
-        // 스케줄러에게 응답 전송
-        if (msgsnd(mq_id, &pkt, sizeof(int), 0) == -1) {
-            perror("msgsnd failed");
-            exit(1);
-        }
+void run_user_process(int idx) {
+    // 공유 메모리 링은 부모가 죽어도 깨워주지 않으므로 부모 종료 시 함께 종료
+    if (transport == TRANSPORT_SHM) prctl(PR_SET_PDEATHSIG, SIGKILL);
+
+    srand(getpid() * time(NULL));
+    UserProc me = {};
+    me.cpu_burst = next_workload_value(idx, WS_BURST);
+
+    while (1) {
+        int arg = 0;
+        int command = child_recv_command(idx, &arg);
+        
+        // 종료 명령 수신 시 루프를 탈출하게끔
+        if (command == ParentCommand::CMD_TERMINATE) break;
+
+        int used = 0;
+        int resp = user_execute(me, idx, command, arg, &used);
+        child_send_response(idx, resp, used);
     }
     exit(0);
 }
 
+// 코루틴 모드의 사용자 프로세스: run_user_process와 같은 루프 (명령은 채널에서 읽고 응답은 co_await로 넘김)
+// 코어별 코루틴은 서로 다른 작업 스레드에서 동시에 실행될 수 있으므로 프로세스별 상태만 건드림
+// (UserProc, coro_chan[idx], 워크로드 위치 replay_pos/workloads[idx]의 rng는 모두 idx마다 따로 있음)
+UserCoroutine run_user_coroutine(int idx) {
+    CoroChannel& ch = coro_chan[idx];
+    UserProc me = {};
+    me.cpu_burst = next_workload_value(idx, WS_BURST);
+
+    while (ch.command != ParentCommand::CMD_TERMINATE) {
+        int used = 0;
+        int resp = user_execute(me, idx, ch.command, ch.arg, &used);
+        co_await CoroReply{&ch, resp, used};
+    }
+}
+
+void setup_coroutines(int count) {
+    coro_chan = new CoroChannel[count];
+    for (int i = 0; i < count; ++i) coro_chan[i].handle = run_user_coroutine(i).handle;
+    long host = sysconf(_SC_NPROCESSORS_ONLN);
+    coro_pool.start(coro_threads > 0 ? coro_threads : (int)std::max(1L, std::min<long>(cpu_count, host)));
+    spin_limit = (host > 1) ? SPIN_LIMIT : 0;
+}
+
+// 모든 코루틴에 CMD_TERMINATE를 먼저 보낸 뒤 종료 응답을 모아 프레임 해제
+void release_coroutines(int count) {
+    if (!coro_chan) return;
+    for (int i = 0; i < count; ++i) send_command(i, i + 1, ParentCommand::CMD_TERMINATE);
+    for (int i = 0; i < count; ++i) {
+        recv_response(i, i + 1);
+        coro_chan[i].handle.destroy();
+    }
+    coro_pool.finish();
+    delete[] coro_chan;
+    coro_chan = nullptr;
+}
+
 // 7. I/O 완료 처리 루틴
-void handle_io_completion(std::vector<ProcInfo>& p_table, std::deque<pid_t>& ready_q) {
-    for (auto& p : p_table) {
-        if (p.is_waiting) {
-            p.io_time--; // I/O 시간 감소
-            
-            if (p.io_time <= 0) {
-                // I/O 완료 후 Ready Queue로 이동
-                p.is_waiting = false;
-                p.io_time = 0;
-                ready_q.push_back(p.pid);
+// I/O 요청 시 완료 시각을 타이밍 휠에 등록
+void block_for_io(ProcInfo& p, int idx, int io_duration) {
+    p.is_waiting = true;
+    p.io_time = io_duration;
+    p.io_done = sys_tick + io_duration;
+    io_wheel.schedule(idx, p.io_done);
+}
+
+void handle_io_completion(std::vector<ProcInfo>& p_table) {
+    static std::vector<int> done;
+    done.clear();
+    io_wheel.expire(sys_tick, p_table, done);
+    // 같은 Tick에 끝난 프로세스는 p_table 순서대로 Ready Queue에 넣음
+    std::sort(done.begin(), done.end());
+
+    for (int idx : done) {
+        // I/O 완료 후 Ready Queue로 이동
+        ProcInfo& p = p_table[idx];
+        p.is_waiting = false;
+        p.io_time = 0;
+        make_ready(p, ENQ_WAKEUP);
+    }
+}
+
+// 7-1. 유휴 구간 건너뛰기 (가상 시간 모드 전용)
+// Ready Queue가 비어 있으면 다음 I/O 완료(또는 MLFQ Boost 같은 정책 이벤트) 직전 Tick까지 한 번에 이동하고, 건너뛴 Tick 수를 반환함
+int skip_idle_ticks(const std::vector<ProcInfo>& p_table, int limit) {
+    int next = io_wheel.next_expiry(sys_tick, p_table);
+    if (next == INT_MAX) return 0;
+    for (const auto& c : cores) next = std::min(next, c.rq->next_event_tick(sys_tick));
+
+    // 마지막 1 Tick은 일반 루프에서 처리해야 I/O 완료 -> Dispatch 순서와 정책 이벤트가 유지됨
+    int skip = std::min(next - 1 - sys_tick, limit - sys_tick);
+    return skip > 0 ? skip : 0;
+}
+
+// 7-2. IPC 왕복 지연 벤치마크
+// 자식 1개를 생성해 전송 방식별로 CMD_EXECUTE_TICK 왕복 시간을 측정함
+static long elapsed_ns(const struct timespec& a, const struct timespec& b) {
+    return (b.tv_sec - a.tv_sec) * 1000000000L + (b.tv_nsec - a.tv_nsec);
+}
+
+// 벤치마크용 자식 1개 준비 (inproc는 커널 안의 사용자 프로세스 상태만 만듦), 실패하면 -1
+pid_t start_bench_child(TransportKind kind) {
+    transport = kind;
+    if (kind == TRANSPORT_SHM && !setup_shm_channels(1)) return -1;
+    if (kind == TRANSPORT_INPROC) {
+        inproc_users.assign(1, UserProc{next_workload_value(0, WS_BURST), 0, 0});
+        return 1;
+    }
+    if (kind == TRANSPORT_CORO) {
+        setup_coroutines(1);
+        return 1;
+    }
+    fflush(stdout); // 자식이 exit()하며 출력 버퍼를 중복 출력하지 않도록
+    pid_t pid = fork();
+    if (pid == 0) run_user_process(0);
+    if (pid < 0) perror("fork failed");
+    return pid;
+}
+
+void stop_bench_child(TransportKind kind, pid_t pid) {
+    if (kind == TRANSPORT_CORO) release_coroutines(1);
+    else if (kind != TRANSPORT_INPROC) {
+        send_command(0, pid, ParentCommand::CMD_TERMINATE);
+        waitpid(pid, NULL, 0);
+    }
+    if (kind == TRANSPORT_SHM) release_shm_channels(1);
+}
+
+void bench_transport(TransportKind kind, const char* name, int rounds) {
+    pid_t pid = start_bench_child(kind);
+    if (pid < 0) return;
+
+    std::vector<long> samples;
+    samples.reserve(rounds);
+    struct timespec t0, t1;
+    for (int i = 0; i < rounds; ++i) {
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        send_command(0, pid, ParentCommand::CMD_EXECUTE_TICK);
+        recv_response(0, pid);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        samples.push_back(elapsed_ns(t0, t1));
+    }
+    stop_bench_child(kind, pid);
+
+    std::sort(samples.begin(), samples.end());
+    long long sum = 0;
+    for (long v : samples) sum += v;
+    printf("%-6s | %10d | %10.0f | %10ld | %10ld | %10ld\n", name, rounds, (double)sum / rounds,
+           samples[rounds / 2], samples[(size_t)(rounds * 0.99)], samples.back());
+}
+
+void run_rtt_benchmark(int rounds) {
+    printf("IPC Round-Trip Latency (ns, %d rounds)\n", rounds);
+    printf("%-6s | %10s | %10s | %10s | %10s | %10s\n", "Mode", "Rounds", "Avg", "p50", "p99", "Max");
+    printf("-----------------------------------------------------------------------\n");
+    bench_transport(TRANSPORT_MSGQ, "msgq", rounds);
+    bench_transport(TRANSPORT_SHM, "shm", rounds);
+    bench_transport(TRANSPORT_INPROC, "inproc", rounds);
+    bench_transport(TRANSPORT_CORO, "coro", rounds);
+}
+
+// 7-2-1. 마이크로벤치마크 (--bench)
+// body(n)가 연산을 n번 수행함. 소요 시간이 BENCH_MIN_NS 이상이 될 때까지 n을 늘려 다시 재고 연산당 시간과 초당 연산 수를 출력
+template <typename F>
+void bench_case(const char* name, F body) {
+    long n = 1;
+    while (true) {
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        body(n);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        long ns = elapsed_ns(t0, t1);
+        if (ns >= BENCH_MIN_NS) {
+            printf("%-36s | %12ld | %10.1f | %14.0f\n", name, n, (double)ns / n, n * 1e9 / ns);
+            return;
+        }
+        // 목표 시간의 1.2배가 되도록 늘림 (한 번에 최대 100배)
+        long next = ns > 0 ? (long)(n * 1.2 * BENCH_MIN_NS / ns) : n * 100;
+        n = std::min(std::max(next, n + 1), n * 100);
+    }
+}
+
+// Dispatch 왕복: CMD_EXECUTE_TICK 전송 -> 자식 1 Tick 실행 -> 응답 수신
+void bench_dispatch(TransportKind kind, const char* name) {
+    pid_t pid = start_bench_child(kind);
+    if (pid < 0) return;
+    bench_case(name, [&](long n) {
+        for (long i = 0; i < n; ++i) {
+            send_command(0, pid, ParentCommand::CMD_EXECUTE_TICK);
+            recv_response(0, pid);
+        }
+    });
+    stop_bench_child(kind, pid);
+}
+
+// 코어 1개(rr)와 BENCH_PROCS개 PCB를 만듦 (i번 프로세스의 PID는 i + 1)
+void setup_bench_kernel(std::vector<ProcInfo>& p_table) {
+    cpu_count = 1;
+    cores.assign(1, CpuCore());
+    cores[0].rq = make_scheduler("rr");
+    sys_tick = 0;
+    pid_index.clear();
+    p_table.clear();
+    for (int i = 0; i < BENCH_PROCS; ++i) {
+        ProcInfo p = {};
+        p.pid = i + 1;
+        p.cpu_time = 1 + i % 10;
+        p.last_cpu = -1;
+        pid_index[p.pid] = i;
+        p_table.push_back(p);
+    }
+}
+
+void run_benchmarks() {
+    printf("Microbenchmarks (%d procs, >= %ld ms per case)\n", BENCH_PROCS, BENCH_MIN_NS / 1000000);
+    printf("%-36s | %12s | %10s | %14s\n", "Benchmark", "Ops", "ns/op", "ops/sec");
+    printf("--------------------------------------------------------------------------------\n");
+
+    bench_dispatch(TRANSPORT_MSGQ, "dispatch round trip (msgq)");
+    bench_dispatch(TRANSPORT_SHM, "dispatch round trip (shm)");
+    bench_dispatch(TRANSPORT_INPROC, "dispatch round trip (inproc)");
+    bench_dispatch(TRANSPORT_CORO, "dispatch round trip (coro)");
+
+    // I/O 완료 처리: 모든 프로세스가 1~16 Tick짜리 I/O를 반복하고, 깨어난 프로세스는 바로 꺼내 다시 Block시킴
+    // 1회 = 1 Tick (평균 BENCH_PROCS / 8.5개 Wakeup)
+    std::vector<ProcInfo> p_table;
+    setup_bench_kernel(p_table);
+    for (int i = 0; i < BENCH_PROCS; ++i) block_for_io(p_table[i], i, 1 + i % 16);
+    bench_case("handle_io_completion (1 tick)", [&](long n) {
+        for (long i = 0; i < n; ++i) {
+            sys_tick++;
+            handle_io_completion(p_table);
+            for (int pid; (pid = cores[0].rq->pick_next()) != -1; ) {
+                int idx = pid_index[pid];
+                block_for_io(p_table[idx], idx, 1 + (sys_tick + idx) % 16);
             }
         }
+    });
+    io_wheel = TimerWheel();
+    delete cores[0].rq;
+
+    // Tick 로그: 1개 실행 + 절반 Ready + 절반 Wait 상태를 /dev/null에 기록 (콘솔 출력 없음)
+    setup_bench_kernel(p_table);
+    for (int i = 1; i < BENCH_PROCS; ++i) {
+        if (i % 2) make_ready(p_table[i], ENQ_NEW);
+        else block_for_io(p_table[i], i, 1 + i % 16);
+    }
+    cores[0].curr = &p_table[0];
+    cores[0].running_pid = p_table[0].pid;
+    FILE* null_fp = fopen("/dev/null", "w");
+    if (!null_fp) { perror("file open failed"); return; }
+    bool saved_quiet = quiet;
+    LogMode saved_mode = log_mode;
+    quiet = true;
+    log_mode = LOG_TEXT;
+    bench_case("write_log (text)", [&](long n) {
+        for (long i = 0; i < n; ++i) write_log(null_fp, sys_tick, p_table);
+    });
+    log_mode = LOG_BINARY;
+    trace_writer.start(null_fp);
+    bench_case("write_log (binary)", [&](long n) {
+        for (long i = 0; i < n; ++i) write_log(null_fp, sys_tick, p_table);
+    });
+    trace_writer.finish();
+    fclose(null_fp);
+    quiet = saved_quiet;
+    log_mode = saved_mode;
+    io_wheel = TimerWheel();
+    delete cores[0].rq;
+    cores.clear();
+}
+
+// 7-3. 코어별 스케줄링
+bool all_cores_idle() {
+    for (const auto& c : cores) {
+        if (c.running_pid != -1 || c.rq->size() > 0) return false;
+    }
+    return true;
+}
+
+// Work Stealing: Run Queue가 가장 긴 코어에서 가장 늦게 실행될 프로세스를 가져옴
+bool steal_work(int thief, std::vector<ProcInfo>& p_table) {
+    int victim = -1;
+    size_t longest = 0;
+    for (int c = 0; c < cpu_count; ++c) {
+        if (c != thief && cores[c].rq->size() > longest) {
+            longest = cores[c].rq->size();
+            victim = c;
+        }
+    }
+    if (victim == -1) return false;
+
+    ProcInfo* p = find_proc(p_table, cores[victim].rq->steal());
+    p->cpu = thief;
+    cores[thief].rq->enqueue(*p, ENQ_MIGRATED); // ready_since 유지 (대기 시간은 계속 누적)
+    cores[thief].steals++;
+    return true;
+}
+
+// 선점 검사 후, 코어가 비어 있으면 Run Queue에서 다음 프로세스를 Dispatch
+void schedule_core(int cpu, std::vector<ProcInfo>& p_table, bool allow_steal) {
+    CpuCore& c = cores[cpu];
+    if (c.batch_left > 0) return; // 배치 실행 중인 코어는 선점되지 않도록 길이를 정해 두었음
+
+    // 선점 검사 (정책이 더 우선인 Ready 프로세스를 발견한 경우)
+    if (c.running_pid != -1 && !allow_steal) {
+        ProcInfo* running = find_proc(p_table, c.running_pid);
+        if (running && c.rq->should_preempt(*running)) {
+            make_ready(*running, ENQ_PREEMPTED);
+            stats.preemptions++;
+            c.running_pid = -1;
+        }
+    }
+    if (c.running_pid != -1) return;
+    if (c.rq->size() == 0 && !(allow_steal && steal_work(cpu, p_table))) return;
+
+    c.running_pid = c.rq->pick_next();
+    ProcInfo* next = find_proc(p_table, c.running_pid);
+    c.q_counter = c.rq->time_slice(*next); // Time Quantum 할당
+
+    c.dispatches++;
+    stats.dispatches++;
+    next->dispatch_count++;
+    stats.total_wait += sys_tick - next->ready_since;
+    next->wait_sum += sys_tick - next->ready_since;
+    if (!next->responded) {
+        next->responded = true;
+        stats.total_response += sys_tick - next->burst_start;
+        next->response_sum += sys_tick - next->burst_start;
+    }
+    if (c.last_pid != c.running_pid) stats.context_switches++;
+    c.last_pid = c.running_pid;
+    if (next->last_cpu != -1 && next->last_cpu != cpu) stats.migrations++;
+    next->last_cpu = cpu;
+}
+
+// 코어 부하(Run Queue 길이 + 실행 중 1) 최대 - 최소
+long load_imbalance() {
+    long lo = LONG_MAX, hi = 0;
+    for (const auto& c : cores) {
+        long load = c.rq->size() + (c.running_pid != -1 ? 1 : 0);
+        lo = std::min(lo, load);
+        hi = std::max(hi, load);
+    }
+    return hi - lo;
+}
+
+// 응답 처리
+void finish_tick(CpuCore& c, ProcInfo& p, int idx, int resp) {
+    p.cpu_time--;
+    c.q_counter--;
+    c.busy_ticks++;
+    p.cpu_ticks++;
+    recorder.on_tick(idx, resp);
+    c.rq->on_run_tick(p);
+
+    if (resp > ChildResponse::RESP_TICK_DONE) {
+        // Case 1 - I/O 요청 (Block)
+        block_for_io(p, idx, resp);
+        stats.bursts++;
+        stats.total_turnaround += sys_tick - p.burst_start + 1;
+        p.bursts++;
+        p.io_ticks += resp;
+        p.turnaround_sum += sys_tick - p.burst_start + 1;
+        // 다음 실행을 위해 CPU Burst 시간 재설정
+        p.cpu_time = next_cpu_estimate(idx); 
+
+        c.running_pid = -1; // CPU 해제
+    } 
+    else {
+        // Case 2 - Time Quantum 만료된 경우 (Preemption)
+        if (c.q_counter <= 0) { 
+            make_ready(p, ENQ_EXPIRED);
+            c.running_pid = -1;
+        } 
+        // Case 3 - CPU Burst 완료된 경우 (즉시 재할당)
+        else if (p.cpu_time <= 0) { 
+            p.cpu_time = next_cpu_estimate(idx);
+        }
+    }
+}
+
+// 배치 길이: 남은 Quantum, 남은 시뮬레이션 시간, 정책상 선점이 일어날 수 있는 시점 중 가장 이른 것
+// 이 범위 안에서는 Tick 단위로 실행해도 같은 결과가 나오므로 커널이 Tick별 상태를 그대로 재구성할 수 있음
+int batch_length(const CpuCore& c, const ProcInfo& p, const std::vector<ProcInfo>& p_table) {
+    long k = std::min(c.q_counter, sim_limit - sys_tick + 1);
+    k = std::min<long>(k, c.rq->run_ahead(p));
+    if (c.rq->preempts_on_wakeup()) {
+        int next = io_wheel.next_expiry(sys_tick, p_table);
+        if (next != INT_MAX) k = std::min<long>(k, next - sys_tick);
+    }
+    return (int)std::max(1L, k);
+}
+
+// 모든 코어의 자식에게 실행 명령을 먼저 보낸 뒤 응답을 모음
+// (서로 다른 코어의 자식들이 호스트 코어에서 동시에 실행함)
+void run_cores(std::vector<ProcInfo>& p_table) {
+    for (auto& c : cores) {
+        c.curr = (c.running_pid != -1) ? find_proc(p_table, c.running_pid) : nullptr;
+        if (!c.curr || c.batch_left > 0) continue;
+
+        int k = batch_mode ? batch_length(c, *c.curr, p_table) : 1;
+        int cmd = (k > 1) ? ParentCommand::CMD_EXECUTE_BATCH : ParentCommand::CMD_EXECUTE_TICK;
+        clock_gettime(CLOCK_MONOTONIC, &c.sent_at);
+        send_command(c.curr - p_table.data(), c.running_pid, cmd, k);
+        stats.round_trips++;
+    }
+    for (auto& c : cores) {
+        if (!c.curr) continue;
+        int idx = c.curr - p_table.data();
+        if (c.batch_left == 0) {
+            int used = 1;
+            c.batch_resp = recv_response(idx, c.curr->pid, &used);
+            c.batch_left = used;
+
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            rtt_hist.record(elapsed_ns(c.sent_at, now));
+        }
+        // 배치로 실행된 Tick은 하나씩 재구성하고, 실제 응답은 마지막 Tick에만 반영
+        c.batch_left--;
+        int resp = (c.batch_left == 0) ? c.batch_resp : ChildResponse::RESP_TICK_DONE;
+        finish_tick(c, *c.curr, idx, resp);
+    }
+}
+
+// 7-4. 정책 비교 요약 출력
+void print_sched_summary() {
+    long n = stats.bursts > 0 ? stats.bursts : 1;
+    printf("\n[ Scheduling Summary: policy=%s, quantum=%d, ticks=%d ]\n", cores[0].rq->name(), t_quantum, sys_tick);
+    printf("Completed Bursts : %ld (%.2f per 1000 ticks)\n", stats.bursts, stats.bursts * 1000.0 / (sys_tick > 0 ? sys_tick : 1));
+    printf("Avg Wait         : %.2f ticks\n", (double)stats.total_wait / n);
+    printf("Avg Response     : %.2f ticks\n", (double)stats.total_response / n);
+    printf("Avg Turnaround   : %.2f ticks\n", (double)stats.total_turnaround / n);
+    printf("Dispatches       : %ld (preemptions %ld, context switches %ld)\n", stats.dispatches, stats.preemptions, stats.context_switches);
+    long busy = 0;
+    for (const auto& c : cores) busy += c.busy_ticks;
+    printf("CPU Utilization  : %.2f%%\n", busy * 100.0 / ((sys_tick > 0 ? sys_tick : 1) * (double)cpu_count));
+    printf("IPC Round Trips  : %ld (%.2f ticks per round trip)\n", stats.round_trips, stats.round_trips > 0 ? (double)busy / stats.round_trips : 0.0);
+    printf("Dispatch RTT (ns): mean %.0f | p50 %lu | p99 %lu | max %lu\n", rtt_hist.mean(),
+           (unsigned long)rtt_hist.percentile(50), (unsigned long)rtt_hist.percentile(99), (unsigned long)rtt_hist.max);
+
+    if (cpu_count == 1) return;
+    long ticks = sys_tick > 0 ? sys_tick : 1;
+    printf("\n[ CPU Summary: %d cores ]\n", cpu_count);
+    printf("%-5s | %-10s | %-10s | %-10s\n", "CPU", "Util(%)", "Dispatches", "Steals");
+    printf("-----------------------------------------------\n");
+    for (int c = 0; c < cpu_count; ++c) {
+        printf("%-5d | %-10.2f | %-10ld | %-10ld\n", c, cores[c].busy_ticks * 100.0 / ticks, cores[c].dispatches, cores[c].steals);
+    }
+    printf("Migrations       : %ld\n", stats.migrations);
+    printf("Avg Imbalance    : %.2f (max - min core load per tick)\n", (double)stats.imbalance_sum / ticks);
+}
+
+// 7-5. 성능 지표 내보내기
+// <prefix>.json (전체 요약), <prefix>_procs.csv (프로세스별), <prefix>_rtt.csv (왕복 지연 히스토그램)
+bool export_metrics(const std::string& prefix, const std::vector<ProcInfo>& p_table) {
+    long ticks = sys_tick > 0 ? sys_tick : 1;
+    long n = stats.bursts > 0 ? stats.bursts : 1;
+    long busy = 0;
+    for (const auto& c : cores) busy += c.busy_ticks;
+
+    FILE* fp = fopen((prefix + "_procs.csv").c_str(), "w");
+    if (!fp) { perror("metrics file open failed"); return false; }
+    fprintf(fp, "pid,cpu_ticks,io_ticks,bursts,dispatches,avg_wait,avg_response,avg_turnaround\n");
+    for (const auto& p : p_table) {
+        long b = p.bursts > 0 ? p.bursts : 1;
+        fprintf(fp, "%d,%ld,%ld,%ld,%ld,%.3f,%.3f,%.3f\n", p.pid, p.cpu_ticks, p.io_ticks, p.bursts, p.dispatch_count,
+                (double)p.wait_sum / b, (double)p.response_sum / b, (double)p.turnaround_sum / b);
+    }
+    fclose(fp);
+
+    fp = fopen((prefix + "_rtt.csv").c_str(), "w");
+    if (!fp) { perror("metrics file open failed"); return false; }
+    fprintf(fp, "bucket_ns,count\n");
+    for (int i = 0; i < HIST_BUCKETS; ++i) {
+        if (rtt_hist.counts[i]) fprintf(fp, "%lu,%lu\n", (unsigned long)LatencyHistogram::value_of(i), (unsigned long)rtt_hist.counts[i]);
     }
+    fclose(fp);
+
+    fp = fopen((prefix + ".json").c_str(), "w");
+    if (!fp) { perror("metrics file open failed"); return false; }
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"config\": {\"policy\": \"%s\", \"quantum\": %d, \"procs\": %d, \"cpus\": %d, \"ticks\": %d, "
+                "\"transport\": \"%s\", \"batch\": %s, \"virtual_time\": %s},\n",
+            cores[0].rq->name(), t_quantum, child_count, cpu_count, sys_tick,
+            transport_name(transport), batch_mode ? "true" : "false", virtual_time ? "true" : "false");
+    fprintf(fp, "  \"summary\": {\"completed_bursts\": %ld, \"throughput_per_1000_ticks\": %.3f, \"avg_wait\": %.3f, "
+                "\"avg_response\": %.3f, \"avg_turnaround\": %.3f, \"dispatches\": %ld, \"context_switches\": %ld, "
+                "\"preemptions\": %ld, \"migrations\": %ld, \"cpu_utilization\": %.4f, \"ipc_round_trips\": %ld},\n",
+            stats.bursts, stats.bursts * 1000.0 / ticks, (double)stats.total_wait / n, (double)stats.total_response / n,
+            (double)stats.total_turnaround / n, stats.dispatches, stats.context_switches, stats.preemptions,
+            stats.migrations, busy / ((double)ticks * cpu_count), stats.round_trips);
+    fprintf(fp, "  \"dispatch_rtt_ns\": {\"count\": %lu, \"mean\": %.1f, \"min\": %lu, \"p50\": %lu, \"p90\": %lu, "
+                "\"p99\": %lu, \"p999\": %lu, \"max\": %lu},\n",
+            (unsigned long)rtt_hist.total, rtt_hist.mean(), (unsigned long)(rtt_hist.total ? rtt_hist.min : 0),
+            (unsigned long)rtt_hist.percentile(50), (unsigned long)rtt_hist.percentile(90), (unsigned long)rtt_hist.percentile(99),
+            (unsigned long)rtt_hist.percentile(99.9), (unsigned long)rtt_hist.max);
+    fprintf(fp, "  \"cores\": [");
+    for (int c = 0; c < cpu_count; ++c) {
+        fprintf(fp, "%s\n    {\"cpu\": %d, \"utilization\": %.4f, \"dispatches\": %ld, \"steals\": %ld}", c ? "," : "",
+                c, cores[c].busy_ticks / (double)ticks, cores[c].dispatches, cores[c].steals);
+    }
+    fprintf(fp, "\n  ],\n  \"processes\": [");
+    for (size_t i = 0; i < p_table.size(); ++i) {
+        const ProcInfo& p = p_table[i];
+        long b = p.bursts > 0 ? p.bursts : 1;
+        fprintf(fp, "%s\n    {\"pid\": %d, \"cpu_ticks\": %ld, \"io_ticks\": %ld, \"bursts\": %ld, \"dispatches\": %ld, "
+                    "\"avg_wait\": %.3f, \"avg_response\": %.3f, \"avg_turnaround\": %.3f}", i ? "," : "",
+                p.pid, p.cpu_ticks, p.io_ticks, p.bursts, p.dispatch_count,
+                (double)p.wait_sum / b, (double)p.response_sum / b, (double)p.turnaround_sum / b);
+    }
+    fprintf(fp, "\n  ]\n}\n");
+    fclose(fp);
+    return true;
 }
 
-// 8. 메인 함수 (Kernel, Scheduler)
-int main() {
-    // 1. 메시지 큐 초기화
-    mq_id = msgget(Q_KEY, IPC_CREAT | 0666);
+void print_usage(const char* prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("  -v, --virtual       가상 시간 모드 (타이머 없이 최대 속도로 실행, 유휴 구간 생략)\n");
+    printf("  -t, --ticks N       시뮬레이션 Tick 수 (기본값 %d)\n", SIM_LIMIT);
+    printf("  -n, --procs N       생성할 자식 프로세스 수 (기본값 %d)\n", CHILD_COUNT);
+    printf("  -c, --cpus N        시뮬레이션 CPU 코어 수 (코어별 Run Queue + Work Stealing, 기본값 1)\n");
+    printf("  -p, --policy P      스케줄링 정책: rr(기본값) | mlfq | sjf | srtf | cfs\n");
+    printf("  -q, --quantum N     RR/MLFQ 기본 Time Quantum (기본값 %d)\n", T_QUANTUM);
+    printf("  -B, --batch         Quantum 단위 배치 실행 (I/O 요청 또는 선점 가능 시점까지 한 번의 IPC로 실행)\n");
+    printf("  -T, --transport K   IPC 전송 방식: msgq(기본값) | shm (공유 메모리 링 + futex) | inproc | coro (C++20 코루틴 + 스레드 풀)\n");
+    printf("      --inproc        fork/IPC 없이 커널 프로세스 안에서 사용자 프로세스 로직을 실행 (-T inproc과 같음)\n");
+    printf("      --threads N     -T coro: 사용자 프로세스 코루틴을 실행할 작업 스레드 수 (기본값: min(코어 수, 호스트 CPU 수))\n");
+    printf("  -s, --seed S        시드 S로 결정적 워크로드 생성 (프로세스별 독립 난수열)\n");
+    printf("  -r, --record FILE   실행 중 관측한 워크로드를 FILE에 기록\n");
+    printf("  -R, --replay FILE   FILE의 워크로드를 재생 (-n을 생략하면 파일의 프로세스 수 사용)\n");
+    printf("  -m, --metrics PREFIX 종료 시 성능 지표를 PREFIX.json, PREFIX_procs.csv, PREFIX_rtt.csv로 저장\n");
+    printf("  -S, --sweep SPEC    설정 조합을 병렬로 실행하고 요약 표 출력 (예: policy=rr,cfs:quantum=1,2,4:procs=10,50:cpus=1,2)\n");
+    printf("  -j, --jobs N        스윕 동시 실행 워커 수 (기본값: 호스트 CPU 수)\n");
+    printf("  -b, --bench-rtt N   전송 방식별 왕복 지연을 N회 측정하고 종료\n");
+    printf("      --bench         Dispatch 왕복, I/O 완료 처리, Tick 로그 기록의 연산당 시간(ns/op, ops/sec)을 측정하고 종료\n");
+    printf("  -l, --log M         로그 파일 형식: text(기본값) | binary (schedule_dump.bin) | none\n");
+    printf("  -Q, --quiet         Tick별 콘솔 출력 생략\n");
+    printf("  -d, --decode FILE   바이너리 로그를 텍스트 형식으로 stdout에 출력하고 종료\n");
+    printf("  -h, --help          도움말 출력\n");
+}
+
+// 시뮬레이션 1회에 대한 설정 중 전역 변수로 두지 않는 항목
+struct SimOptions {
+    const char* policy = "rr";
+    const char* record_path = NULL;
+    const char* metrics_prefix = NULL;
+    bool seeded = false;
+    uint64_t seed = 0;
+};
+
+double wall_elapsed = 0; // 마지막 시뮬레이션의 실제 소요 시간 (초)
+
+// 8. 시뮬레이션 실행 (Kernel, Scheduler)
+// 전역 설정(child_count, t_quantum, cpu_count 등)과 opt로 시뮬레이션 1회를 수행함
+int run_simulation(const SimOptions& opt) {
+    cores.resize(cpu_count);
+    for (auto& c : cores) {
+        c.rq = make_scheduler(opt.policy);
+        if (!c.rq) { fprintf(stderr, "unknown policy: %s\n", opt.policy); return 1; }
+    }
+
+    if (opt.seeded) {
+        seed_workloads(opt.seed, child_count);
+        workload_mode = WL_SEED;
+    }
+    if (workload_mode == WL_REPLAY) replay_pos.assign((size_t)child_count * WS_COUNT, 0);
+    if (opt.record_path) recorder.start(child_count);
+
+    // 1. 메시지 큐 초기화 (IPC_PRIVATE: 동시에 실행되는 다른 시뮬레이션과 큐를 공유하지 않음)
+    mq_id = msgget(IPC_PRIVATE, IPC_CREAT | 0600);
     if (mq_id == -1) { perror("msgget failed"); return 1; }
 
+    if (transport == TRANSPORT_SHM && !setup_shm_channels(child_count)) return 1;
+
     std::vector<ProcInfo> p_table; 
-    std::deque<pid_t> ready_q;     
 
     // 2. 프로세스 생성
-    for (int i = 0; i < CHILD_COUNT; ++i) {
-        pid_t pid = fork();
+    p_table.reserve(child_count);
+    pid_index.reserve(child_count);
+    if (transport == TRANSPORT_INPROC) inproc_users.resize(child_count);
+    if (transport == TRANSPORT_CORO) setup_coroutines(child_count);
+    for (int i = 0; i < child_count; ++i) {
+        pid_t pid;
+        if (transport == TRANSPORT_INPROC || transport == TRANSPORT_CORO) {
+            // 자식을 만들지 않으므로 PID 대신 1부터 시작하는 번호를 사용
+            pid = i + 1;
+            if (transport == TRANSPORT_INPROC) inproc_users[i].cpu_burst = next_workload_value(i, WS_BURST);
+        } else {
+            pid = fork();
+        }
         if (pid == 0) { 
-            run_user_process(); 
+            run_user_process(i); 
         }
         else if (pid > 0) { 
-            // PCB 초기화 및 Ready Queue 등록
-            ProcInfo p = {pid, (rand() % 10) + 1, 0, false};
+            // PCB 초기화
+            ProcInfo p = {};
+            p.pid = pid;
+            p.cpu_time = next_cpu_estimate(i);
+            p.cpu = i % cpu_count;
+            p.last_cpu = -1;
+            pid_index[pid] = p_table.size();
             p_table.push_back(p);
-            ready_q.push_back(pid);
         } else { 
             perror("fork failed"); return 1; 
         }
     }
+    // Ready Queue 등록 (p_table이 확정된 뒤에 해야 정책이 PCB를 수정할 수 있음)
+    for (auto& p : p_table) make_ready(p, ENQ_NEW);
 
-    // 3. 타이머 및 시그널 핸들러 설정
-    struct sigaction sa;
-    memset(&sa, 0, sizeof(sa));
-    sa.sa_handler = &on_timer_tick;
-    sigaction(SIGALRM, &sa, NULL);
+    // 3. 타이머 및 시그널 핸들러 설정 (가상 시간 모드에서는 타이머를 사용하지 않음)
+    if (!virtual_time) {
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = &on_timer_tick;
+        sigaction(SIGALRM, &sa, NULL);
 
-    struct itimerval timer;
-    // 10ms 간격으로 설정 (1 Tick)
-    timer.it_value.tv_sec = 0; timer.it_value.tv_usec = 10000;
-    timer.it_interval.tv_sec = 0; timer.it_interval.tv_usec = 10000;
-    setitimer(ITIMER_REAL, &timer, NULL);
+        struct itimerval timer;
+        // 10ms 간격으로 설정 (1 Tick)
+        timer.it_value.tv_sec = 0; timer.it_value.tv_usec = 10000;
+        timer.it_interval.tv_sec = 0; timer.it_interval.tv_usec = 10000;
+        setitimer(ITIMER_REAL, &timer, NULL);
+    }
 
     // 4. 로그 파일 설정
-    FILE* log_fp = fopen("schedule_dump.txt", "w");
-    if (!log_fp) { perror("file open failed"); return 1; }
+    FILE* log_fp = NULL;
+    if (log_mode != LOG_NONE) {
+        log_fp = fopen(log_mode == LOG_BINARY ? "schedule_dump.bin" : "schedule_dump.txt", log_mode == LOG_BINARY ? "wb" : "w");
+        if (!log_fp) { perror("file open failed"); return 1; }
+    }
+    // 바이너리 로그 기록 스레드는 fork 이후에 시작해야 함
+    if (log_mode == LOG_BINARY) trace_writer.start(log_fp);
 
-    pid_t running_pid = -1; // 현재 실행 중인 프로세스 ID
+    struct timespec wall_start, wall_end;
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
 
     // 5. 메인 스케줄링
-    while (sys_tick < SIM_LIMIT) {
-        pause(); // 시그널 대기 (Idle)
+    while (sys_tick < sim_limit) {
+        if (virtual_time) {
+            // 가상 시간 모드: 실행할 프로세스가 없으면 다음 I/O 완료 시점까지 건너뜀
+            if (all_cores_idle()) {
+                int skipped = skip_idle_ticks(p_table, sim_limit);
+                if (skipped > 0) {
+                    write_idle_log(log_fp, sys_tick + 1, sys_tick + skipped);
+                    sys_tick += skipped;
+                    if (sys_tick >= sim_limit) break;
+                }
+            }
+            alarm_triggered = 1; // 타이머 대기 없이 바로 다음 Tick 진행
+        } else {
+            pause(); // 시그널 대기 (Idle)
+        }
         
         if (alarm_triggered) { 
             alarm_triggered = 0;
             sys_tick++; 
 
             // 1. I/O 완료 프로세스 처리
-            handle_io_completion(p_table, ready_q);
+            handle_io_completion(p_table);
+            for (auto& c : cores) c.rq->on_system_tick(sys_tick, p_table);
 
-            // 2. 스케줄링 결정 (Dispatch)
-            if (running_pid == -1 && !ready_q.empty()) {
-                running_pid = ready_q.front();
-                ready_q.pop_front();
-                q_counter = T_QUANTUM; // Time Quantum 할당
+            // 2. 선점 검사 및 스케줄링 결정 (Dispatch)
+            // 모든 코어가 자기 Run Queue에서 먼저 고른 뒤, 비어 있는 코어만 다른 코어에서 훔쳐옴
+            for (int c = 0; c < cpu_count; ++c) schedule_core(c, p_table, false);
+            if (cpu_count > 1) {
+                for (int c = 0; c < cpu_count; ++c) schedule_core(c, p_table, true);
+                stats.imbalance_sum += load_imbalance();
             }
-            
-            ProcInfo* curr_proc_info = nullptr; 
 
             // 3. 프로세스 실행
-            if (running_pid != -1) {
-                for (auto& p : p_table) { 
-                    if (p.pid == running_pid) { 
-                        curr_proc_info = &p; 
-                        break; 
-                    } 
-                }
-
-                if (curr_proc_info) {
-                    IpcMsg pkt;
-                    pkt.mtype = running_pid;
-                    pkt.command = ParentCommand::CMD_EXECUTE_TICK; 
-                    
-                    // 실행 명령 전송 및 응답 대기 (IPC Handshake)
-                    msgsnd(mq_id, &pkt, sizeof(int), 0);
-                    // 부모는 자기자신(getpid) 앞으로 온 메시지를 받아야 함
-                    msgrcv(mq_id, &pkt, sizeof(int), getpid(), 0);
-                    
-                    curr_proc_info->cpu_time--;
-                    q_counter--;
-
-                    // 응답 처리
-                    if (pkt.command > ChildResponse::RESP_TICK_DONE) {
-                        // Case 1 - I/O 요청 (Block)
-                        curr_proc_info->is_waiting = true;
-                        curr_proc_info->io_time = pkt.command;
-                        // 다음 실행을 위해 CPU Burst 시간 재설정
-                        curr_proc_info->cpu_time = (rand() % 10) + 1; 
-
-                        running_pid = -1; // CPU 해제
-                    } 
-                    else {
-                        // Case 2 - Time Quantum 만료된 경우 (Preemption)
-                        if (q_counter <= 0) { 
-                            ready_q.push_back(running_pid); 
-                            running_pid = -1;
-                        } 
-                        // Case 3 - CPU Burst 완료된 경우 (즉시 재할당)
-                        else if (curr_proc_info->cpu_time <= 0) { 
-                            curr_proc_info->cpu_time = (rand() % 10) + 1;
-                        }
-                    }
-                }
-            } 
+            run_cores(p_table);
             
             // 4. 로깅
-            write_log(log_fp, sys_tick, curr_proc_info, ready_q, p_table); 
+            write_log(log_fp, sys_tick, p_table); 
         }
     }
     
     // 6. 시뮬레이션 종료
-    fclose(log_fp);
-    IpcMsg pkt; 
-    pkt.command = ParentCommand::CMD_TERMINATE; 
+    clock_gettime(CLOCK_MONOTONIC, &wall_end);
+    wall_elapsed = (wall_end.tv_sec - wall_start.tv_sec) + (wall_end.tv_nsec - wall_start.tv_nsec) / 1e9;
+
+    if (log_mode == LOG_BINARY) trace_writer.finish();
+    if (log_fp) fclose(log_fp);
     
-    for (auto& p : p_table) { 
-        pkt.mtype = p.pid; 
-        msgsnd(mq_id, &pkt, sizeof(int), 0); 
-        waitpid(p.pid, NULL, 0); 
+    release_coroutines(child_count);
+    for (size_t i = 0; transport != TRANSPORT_INPROC && transport != TRANSPORT_CORO && i < p_table.size(); ++i) { 
+        send_command(i, p_table[i].pid, ParentCommand::CMD_TERMINATE);
+        waitpid(p_table[i].pid, NULL, 0); 
     }
+    if (opt.record_path && recorder.save(opt.record_path)) printf("Workload recorded to '%s'\n", opt.record_path);
     
+    release_shm_channels(child_count);
     msgctl(mq_id, IPC_RMID, NULL); 
-    printf("Simulation Completed.\n");
+    print_sched_summary();
+    if (opt.metrics_prefix && export_metrics(opt.metrics_prefix, p_table)) printf("Metrics saved to '%s.json'\n", opt.metrics_prefix);
+    for (auto& c : cores) delete c.rq;
+    printf("Simulation Completed. (%d ticks, %s mode, %.3f sec)\n", sys_tick, virtual_time ? "virtual" : "real-time", wall_elapsed);
     
     return 0;
-}
\ No newline at end of file
+}
+
+// 8-1. 파라미터 스윕
+// 설정 조합마다 워커 프로세스를 fork해 최대 jobs개를 동시에 실행함
+// 워커는 각자 IPC_PRIVATE 큐/공유 메모리를 만들므로 서로 충돌하지 않고, 결과는 공유 메모리로 모음
+struct SweepPoint {
+    const char* policy;
+    int procs, quantum, cpus;
+};
+
+struct SweepResult {
+    int done;           // 워커가 시뮬레이션을 끝내고 결과를 기록했으면 1
+    long bursts, context_switches;
+    double throughput, avg_wait, avg_response, avg_turnaround, cpu_util, wall_sec;
+};
+
+static bool parse_int_list(const char* str, std::vector<int>& out) {
+    out.clear();
+    std::istringstream in(str);
+    std::string tok;
+    while (std::getline(in, tok, ',')) {
+        int v = atoi(tok.c_str());
+        if (v <= 0) return false;
+        out.push_back(v);
+    }
+    return !out.empty();
+}
+
+// 형식: key=v1,v2:key=v1,... (key: policy | procs | quantum | cpus), 지정하지 않은 항목은 현재 설정값 1개
+bool parse_sweep(const char* spec, const char* policy, std::vector<SweepPoint>& points) {
+    static std::vector<std::string> policies; // SweepPoint가 문자열을 가리키므로 스윕이 끝날 때까지 유지
+    policies.assign(1, policy);
+    std::vector<int> procs(1, child_count), quantums(1, t_quantum), cpus(1, cpu_count);
+
+    std::istringstream in(spec);
+    std::string item;
+    while (std::getline(in, item, ':')) {
+        size_t eq = item.find('=');
+        if (eq == std::string::npos) { fprintf(stderr, "invalid sweep item: %s\n", item.c_str()); return false; }
+        std::string key = item.substr(0, eq), values = item.substr(eq + 1);
+        bool ok = true;
+        if (key == "policy") {
+            policies.clear();
+            std::istringstream vs(values);
+            std::string v;
+            while (std::getline(vs, v, ',')) {
+                Scheduler* rq = make_scheduler(v.c_str());
+                if (!rq) { fprintf(stderr, "unknown policy: %s\n", v.c_str()); return false; }
+                delete rq;
+                policies.push_back(v);
+            }
+            ok = !policies.empty();
+        }
+        else if (key == "procs") ok = parse_int_list(values.c_str(), procs);
+        else if (key == "quantum") ok = parse_int_list(values.c_str(), quantums);
+        else if (key == "cpus") ok = parse_int_list(values.c_str(), cpus) && *std::max_element(cpus.begin(), cpus.end()) <= MAX_CPUS;
+        else { fprintf(stderr, "unknown sweep key: %s\n", key.c_str()); return false; }
+        if (!ok) { fprintf(stderr, "invalid sweep values: %s\n", item.c_str()); return false; }
+    }
+
+    points.clear();
+    for (const auto& pol : policies)
+        for (int n : procs)
+            for (int q : quantums)
+                for (int c : cpus) points.push_back(SweepPoint{pol.c_str(), n, q, c});
+    return true;
+}
+
+// 워커: 설정을 적용해 출력 없이 1회 실행하고 결과를 기록한 뒤 종료
+static void run_sweep_worker(const SweepPoint& pt, SimOptions opt, SweepResult* out) {
+    int devnull = open("/dev/null", O_WRONLY);
+    if (devnull >= 0) dup2(devnull, STDOUT_FILENO);
+
+    child_count = pt.procs;
+    t_quantum = pt.quantum;
+    cpu_count = pt.cpus;
+    virtual_time = true;
+    quiet = true;
+    log_mode = LOG_NONE;
+    opt.policy = pt.policy;
+    opt.record_path = NULL;
+    opt.metrics_prefix = NULL;
+
+    int rc = run_simulation(opt);
+    if (rc == 0) {
+        long ticks = sys_tick > 0 ? sys_tick : 1;
+        long n = stats.bursts > 0 ? stats.bursts : 1;
+        long busy = 0;
+        for (const auto& c : cores) busy += c.busy_ticks;
+        out->bursts = stats.bursts;
+        out->context_switches = stats.context_switches;
+        out->throughput = stats.bursts * 1000.0 / ticks;
+        out->avg_wait = (double)stats.total_wait / n;
+        out->avg_response = (double)stats.total_response / n;
+        out->avg_turnaround = (double)stats.total_turnaround / n;
+        out->cpu_util = busy / ((double)ticks * cpu_count);
+        out->wall_sec = wall_elapsed;
+        out->done = 1;
+    }
+    fflush(stdout);
+    _exit(rc);
+}
+
+int run_sweep(const char* spec, int jobs, const SimOptions& base) {
+    std::vector<SweepPoint> points;
+    if (!parse_sweep(spec, base.policy, points)) return 1;
+    if (jobs <= 0) jobs = std::max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+
+    void* mem = mmap(NULL, sizeof(SweepResult) * points.size(), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) { perror("mmap failed"); return 1; }
+    SweepResult* results = new (mem) SweepResult[points.size()]();
+
+    printf("Sweep: %zu configurations, %d jobs, %d ticks each\n", points.size(), jobs, sim_limit);
+    fflush(stdout); // 워커가 출력 버퍼를 물려받지 않도록
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    size_t next = 0;
+    int running = 0;
+    while (next < points.size() || running > 0) {
+        if (next < points.size() && running < jobs) {
+            pid_t pid = fork();
+            if (pid == 0) run_sweep_worker(points[next], base, &results[next]);
+            if (pid < 0) { perror("fork failed"); break; }
+            next++;
+            running++;
+            continue;
+        }
+        if (wait(NULL) == -1) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        running--;
+    }
+    while (running > 0 && wait(NULL) != -1) running--;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    printf("%-6s | %5s | %7s | %4s | %8s | %9s | %8s | %8s | %8s | %8s | %8s | %7s\n", "Policy", "Procs", "Quantum", "CPUs",
+           "Bursts", "Thru/1kT", "AvgWait", "AvgResp", "AvgTAT", "CPU Util", "CtxSw", "Wall(s)");
+    printf("---------------------------------------------------------------------------------------------------------------\n");
+    for (size_t i = 0; i < points.size(); ++i) {
+        const SweepPoint& pt = points[i];
+        const SweepResult& r = results[i];
+        if (!r.done) {
+            printf("%-6s | %5d | %7d | %4d | %s\n", pt.policy, pt.procs, pt.quantum, pt.cpus, "failed");
+            continue;
+        }
+        printf("%-6s | %5d | %7d | %4d | %8ld | %9.2f | %8.2f | %8.2f | %8.2f | %7.2f%% | %8ld | %7.3f\n", pt.policy, pt.procs,
+               pt.quantum, pt.cpus, r.bursts, r.throughput, r.avg_wait, r.avg_response, r.avg_turnaround, r.cpu_util * 100,
+               r.context_switches, r.wall_sec);
+    }
+    printf("Sweep Completed. (%.3f sec)\n", elapsed_ns(t0, t1) / 1e9);
+
+    if (base.metrics_prefix) {
+        std::string path = std::string(base.metrics_prefix) + "_sweep.csv";
+        FILE* fp = fopen(path.c_str(), "w");
+        if (!fp) { perror("metrics file open failed"); }
+        else {
+            fprintf(fp, "policy,procs,quantum,cpus,completed,bursts,throughput_per_1000_ticks,avg_wait,avg_response,"
+                        "avg_turnaround,cpu_utilization,context_switches,wall_sec\n");
+            for (size_t i = 0; i < points.size(); ++i) {
+                const SweepPoint& pt = points[i];
+                const SweepResult& r = results[i];
+                fprintf(fp, "%s,%d,%d,%d,%d,%ld,%.3f,%.3f,%.3f,%.3f,%.4f,%ld,%.4f\n", pt.policy, pt.procs, pt.quantum, pt.cpus,
+                        r.done, r.bursts, r.throughput, r.avg_wait, r.avg_response, r.avg_turnaround, r.cpu_util,
+                        r.context_switches, r.wall_sec);
+            }
+            fclose(fp);
+            printf("Sweep results saved to '%s'\n", path.c_str());
+        }
+    }
+    munmap(mem, sizeof(SweepResult) * points.size());
+    return 0;
+}
+
+// 9. 메인 함수
+int main(int argc, char* argv[]) {
+    // 0. 실행 옵션 파싱
+    static const struct option long_opts[] = {
+        {"virtual", no_argument,       NULL, 'v'},
+        {"ticks",   required_argument, NULL, 't'},
+        {"procs",   required_argument, NULL, 'n'},
+        {"cpus",    required_argument, NULL, 'c'},
+        {"policy",  required_argument, NULL, 'p'},
+        {"quantum", required_argument, NULL, 'q'},
+        {"batch",   no_argument,       NULL, 'B'},
+        {"transport", required_argument, NULL, 'T'},
+        {"inproc",  no_argument,       NULL, 'I'},
+        {"seed",    required_argument, NULL, 's'},
+        {"record",  required_argument, NULL, 'r'},
+        {"replay",  required_argument, NULL, 'R'},
+        {"sweep",   required_argument, NULL, 'S'},
+        {"jobs",    required_argument, NULL, 'j'},
+        {"bench-rtt", required_argument, NULL, 'b'},
+        {"bench",   no_argument,       NULL, 1000},
+        {"threads", required_argument, NULL, 1001},
+        {"metrics", required_argument, NULL, 'm'},
+        {"log",     required_argument, NULL, 'l'},
+        {"quiet",   no_argument,       NULL, 'Q'},
+        {"decode",  required_argument, NULL, 'd'},
+        {"help",    no_argument,       NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int opt;
+    int bench_rounds = 0;
+    bool bench = false;
+    int jobs = 0;
+    SimOptions sim;
+    const char* replay_path = NULL;
+    const char* sweep_spec = NULL;
+    bool procs_given = false;
+    while ((opt = getopt_long(argc, argv, "vt:n:c:p:q:BT:Is:r:R:S:j:b:m:l:Qd:h", long_opts, NULL)) != -1) {
+        switch (opt) {
+            case 'v': virtual_time = true; break;
+            case 't': sim_limit = atoi(optarg); break;
+            case 'n': child_count = atoi(optarg); procs_given = true; break;
+            case 'c': cpu_count = atoi(optarg); break;
+            case 'p': sim.policy = optarg; break;
+            case 'q': t_quantum = atoi(optarg); break;
+            case 'B': batch_mode = true; break;
+            case 'T':
+                if (strcmp(optarg, "msgq") == 0) transport = TRANSPORT_MSGQ;
+                else if (strcmp(optarg, "shm") == 0) transport = TRANSPORT_SHM;
+                else if (strcmp(optarg, "inproc") == 0) transport = TRANSPORT_INPROC;
+                else if (strcmp(optarg, "coro") == 0) transport = TRANSPORT_CORO;
+                else { fprintf(stderr, "unknown transport: %s\n", optarg); return 1; }
+                break;
+            case 'I': transport = TRANSPORT_INPROC; break;
+            case 's': sim.seed = strtoull(optarg, NULL, 0); sim.seeded = true; break;
+            case 'r': sim.record_path = optarg; break;
+            case 'R': replay_path = optarg; break;
+            case 'S': sweep_spec = optarg; break;
+            case 'j': jobs = atoi(optarg); break;
+            case 'b': bench_rounds = atoi(optarg); break;
+            case 1000: bench = true; break;
+            case 1001: coro_threads = atoi(optarg); break;
+            case 'm': sim.metrics_prefix = optarg; break;
+            case 'l':
+                if (strcmp(optarg, "text") == 0) log_mode = LOG_TEXT;
+                else if (strcmp(optarg, "binary") == 0) log_mode = LOG_BINARY;
+                else if (strcmp(optarg, "none") == 0) log_mode = LOG_NONE;
+                else { fprintf(stderr, "unknown log mode: %s\n", optarg); return 1; }
+                break;
+            case 'Q': quiet = true; break;
+            case 'd': return decode_trace(optarg);
+            case 'h': print_usage(argv[0]); return 0;
+            default:  print_usage(argv[0]); return 1;
+        }
+    }
+    if (replay_path) {
+        if (sim.seeded) { fprintf(stderr, "--seed and --replay cannot be combined\n"); return 1; }
+        int recorded = load_workload(replay_path);
+        if (recorded < 0) return 1;
+        // -n을 지정하면 파일의 프로세스 번호를 modulo로 재사용
+        if (!procs_given) child_count = recorded;
+    }
+    if (sim_limit <= 0) { fprintf(stderr, "invalid tick count\n"); return 1; }
+    if (t_quantum <= 0) { fprintf(stderr, "invalid time quantum\n"); return 1; }
+    if (child_count <= 0) { fprintf(stderr, "invalid process count\n"); return 1; }
+
+    if (cpu_count <= 0 || cpu_count > MAX_CPUS) { fprintf(stderr, "invalid cpu count\n"); return 1; }
+    if (coro_threads < 0) { fprintf(stderr, "invalid thread count\n"); return 1; }
+    if (bench_rounds > 0 || bench) {
+        mq_id = msgget(IPC_PRIVATE, IPC_CREAT | 0600);
+        if (mq_id == -1) { perror("msgget failed"); return 1; }
+        if (bench) run_benchmarks();
+        else run_rtt_benchmark(bench_rounds);
+        msgctl(mq_id, IPC_RMID, NULL);
+        return 0;
+    }
+    if (sweep_spec) return run_sweep(sweep_spec, jobs, sim);
+
+    return run_simulation(sim);
+}
@@ -12,6 +12,28 @@
 #include <sys/msg.h>
 #include <sys/wait.h>
 #include <signal.h>
+#include <getopt.h>
+#include <list>
+#include <set>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdarg>
+#include <sched.h>
+#include <cmath>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <climits>
+#include <cstddef>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 using namespace std;
 
@@ -21,7 +43,27 @@ using namespace std;
 #define PAGE_SIZE 4096        
 #define PHY_MEM_SIZE (512 * 4096) // 512 Frames (2MB)
 #define TOTAL_FRAMES (PHY_MEM_SIZE / PAGE_SIZE)
-#define ACCESS_PER_TICK 10     
+#define ACCESS_PER_TICK 10     // 기본 배치 크기 (한 번 실행될 때의 메모리 접근 수)
+#define MSGQ_MAX_BATCH 256     // 메시지 큐 한 메시지에 담을 수 있는 최대 접근 수
+#define RING_BATCHES 4         // 공유 메모리 링에서 자식이 미리 채워 둘 수 있는 배치 수
+#define SPIN_LIMIT 256         // futex 대기 전 busy-wait 횟수
+#define VIRTUAL_PAGES 200      // 프로세스당 사용하는 가상 페이지 수 (기본값)
+
+// Paging (x86-64 방식 4단계, 48비트 VA)
+#define PAGE_SHIFT 12
+#define PT_LEVELS 4
+#define PT_BITS 9
+#define PT_ENTRIES (1 << PT_BITS)  // 단계별 테이블 항목 수 (512)
+#define VPN_BITS (PT_LEVELS * PT_BITS) // 36비트 VPN
+#define HUGE_PAGES PT_ENTRIES      // 2MB Huge Page 하나가 차지하는 4KB 페이지 수
+#define PTE_SIZE 8                 // 실제 하드웨어 PTE 크기 (footprint 계산용)
+#define DASHBOARD_PROCS 10         // 대시보드에 표시할 프로세스 수
+
+// 런타임 설정 (실행 옵션으로 변경)
+int process_count = PROCESS_COUNT;
+int total_frames = TOTAL_FRAMES;
+int process_pages = VIRTUAL_PAGES;
+bool huge_pages = false;           // 2MB 단위 매핑 시도 여부
 
 // IPC Keys
 #define KEY_Q1 11111
@@ -37,7 +79,7 @@ const vector<string> BATTLE_QUOTES = {
     "Swap Out 되신 걸 환영합니다. ( ◡‿◡ *)",       
     "메모리 부족? 난 아닌데? ┐(￣∀￣)┌",           
     "저리 가! 너무 좁잖아! ヽ( `д´*)ノ",            
-    "FIFO 법칙에 의해 퇴거 조치합니다. (￣^￣)ゞ"   
+    "교체 정책에 의해 퇴거 조치합니다. (￣^￣)ゞ"   
 };
 
 // 2. Data Structures (Logic)
@@ -46,18 +88,152 @@ struct PageEntry {
     bool valid;
     bool is_swapped; // Swap 영역에 있는지 여부
     int frame_number;
+    int swap_slot;   // Swap 파일 안의 위치 + 1 (0이면 아직 기록된 적 없음 -> 다시 접근하면 0으로 채운 새 페이지)
 };
 
 // [Logic Enhancement] Reverse Mapping (Frame -> Owner)
 // Physical 프레임이 누구 것인지 추적하기 위한것 (Replacement 시 Invalid 처리를 위해 필요함)
+// 공유 영역/fork로 여러 프로세스가 같은 프레임을 매핑하면 나머지 매핑은 sharers에 둠 (모두 같은 VPN)
 struct FrameInfo {
-    int pid;      // 소유자 PID (logical_pid)
-    int page_idx; // VA
+    int pid;      // 소유자 PID (logical_pid), 대표 매핑
+    long vpn;     // VA >> PAGE_SHIFT
+    bool dirty;      // 적재 이후 쓰기가 있었는지 (Swap Out 시 Write-back 필요)
+    bool prefetched; // Read-ahead로 적재된 뒤 아직 접근되지 않음
+    vector<int> sharers; // pid 외에 이 프레임을 매핑한 프로세스 (참조 수 = 1 + sharers.size())
+};
+
+struct AccessRec {
+    long vpn;   // 접근할 VPN
+    bool write; // 쓰기 접근 여부
 };
 
+// 메시지 큐 모드: 실제로 보내는 길이는 batch_size개 접근까지만 (msg_size 참고)
 struct MsgBuf {
     long mtype; int pid; int cpu_burst; int io_burst;
-    int access_pages[ACCESS_PER_TICK]; 
+    AccessRec accesses[MSGQ_MAX_BATCH];
+};
+
+// 2-1. Radix Page Table (4단계, 필요한 테이블만 생성)
+// PGD -> PUD -> PMD -> PTE 순으로 VPN 9비트씩 인덱싱함
+// PMD 항목은 하위 PTE 테이블 대신 2MB Huge Page(연속 512 프레임)를 직접 가리킬 수 있음
+struct PtLeaf { PageEntry pte[PT_ENTRIES]; };
+struct PtPmd  { PtLeaf* leaf[PT_ENTRIES]; int huge_base[PT_ENTRIES]; }; // huge_base: -1이면 Huge 매핑 아님
+struct PtPud  { PtPmd* pmd[PT_ENTRIES]; };
+struct PtPgd  { PtPud* pud[PT_ENTRIES]; };
+
+// 전체 프로세스의 Page Table 메모리 사용량
+struct PageTableStats {
+    long tables[PT_LEVELS];   // 단계별 할당된 테이블 수 (0: PGD ... 3: PTE)
+    long host_bytes;          // 시뮬레이터가 실제로 사용한 메모리
+    long huge_maps, huge_splits;
+};
+PageTableStats pt_stats = {};
+
+class RadixPageTable {
+    PtPgd* pgd = nullptr;
+
+    static int index(long vpn, int level) { return (vpn >> ((PT_LEVELS - 1 - level) * PT_BITS)) & (PT_ENTRIES - 1); }
+
+    template <typename T> static T* alloc_table(int level) {
+        T* t = new T();
+        // 멀티 CPU 모드에서는 여러 커널 스레드가 동시에 테이블을 만들 수 있음
+        __atomic_fetch_add(&pt_stats.tables[level], 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&pt_stats.host_bytes, (long)sizeof(T), __ATOMIC_RELAXED);
+        return t;
+    }
+    static PtPmd* alloc_pmd() {
+        PtPmd* t = alloc_table<PtPmd>(2);
+        fill(t->huge_base, t->huge_base + PT_ENTRIES, -1);
+        return t;
+    }
+
+    // vpn을 담당하는 PMD (create가 false면 없을 때 nullptr)
+    PtPmd* find_pmd(long vpn, bool create) {
+        if (!pgd) { if (!create) return nullptr; pgd = alloc_table<PtPgd>(0); }
+        PtPud*& pud = pgd->pud[index(vpn, 0)];
+        if (!pud) { if (!create) return nullptr; pud = alloc_table<PtPud>(1); }
+        PtPmd*& pmd = pud->pmd[index(vpn, 1)];
+        if (!pmd) { if (!create) return nullptr; pmd = alloc_pmd(); }
+        return pmd;
+    }
+
+public:
+    ~RadixPageTable() {
+        if (!pgd) return;
+        for (PtPud* pud : pgd->pud) {
+            if (!pud) continue;
+            for (PtPmd* pmd : pud->pmd) {
+                if (!pmd) continue;
+                for (PtLeaf* leaf : pmd->leaf) delete leaf;
+                delete pmd;
+            }
+            delete pud;
+        }
+        delete pgd;
+    }
+
+    // Page Walk: 유효한 매핑이면 프레임 번호 반환 (없으면 -1), *levels = 읽은 테이블 단계 수
+    int translate(long vpn, int* levels) {
+        *levels = PT_LEVELS;
+        PtPmd* pmd = find_pmd(vpn, false);
+        if (!pmd) return -1;
+        int i = index(vpn, 2);
+        if (pmd->huge_base[i] >= 0) {
+            *levels = PT_LEVELS - 1; // PMD에서 변환 종료
+            return pmd->huge_base[i] + index(vpn, 3);
+        }
+        PtLeaf* leaf = pmd->leaf[i];
+        if (!leaf || !leaf->pte[index(vpn, 3)].valid) return -1;
+        return leaf->pte[index(vpn, 3)].frame_number;
+    }
+
+    // 이미 있는 4KB PTE (테이블이 없거나 Huge 매핑이면 nullptr)
+    PageEntry* find_pte(long vpn) {
+        PtPmd* pmd = find_pmd(vpn, false);
+        if (!pmd || !pmd->leaf[index(vpn, 2)]) return nullptr;
+        return &pmd->leaf[index(vpn, 2)]->pte[index(vpn, 3)];
+    }
+
+    // 4KB PTE (경로상의 테이블은 필요할 때 생성)
+    PageEntry& pte(long vpn) {
+        PtPmd* pmd = find_pmd(vpn, true);
+        PtLeaf*& leaf = pmd->leaf[index(vpn, 2)];
+        if (!leaf) leaf = alloc_table<PtLeaf>(3);
+        return leaf->pte[index(vpn, 3)];
+    }
+
+    // 2MB 영역 전체에 아직 4KB 매핑이 없을 때만 Huge Page로 매핑
+    bool can_map_huge(long vpn) {
+        PtPmd* pmd = find_pmd(vpn, false);
+        return !pmd || (!pmd->leaf[index(vpn, 2)] && pmd->huge_base[index(vpn, 2)] < 0);
+    }
+    void map_huge(long vpn, int base_frame) {
+        find_pmd(vpn, true)->huge_base[index(vpn, 2)] = base_frame;
+        pt_stats.huge_maps++;
+    }
+    bool is_huge(long vpn) {
+        PtPmd* pmd = find_pmd(vpn, false);
+        return pmd && pmd->huge_base[index(vpn, 2)] >= 0;
+    }
+
+    // Huge Page를 4KB PTE 512개로 분할 (일부 프레임만 회수할 때 사용)
+    void split_huge(long vpn) {
+        PtPmd* pmd = find_pmd(vpn, false);
+        int i = index(vpn, 2);
+        PtLeaf* leaf = alloc_table<PtLeaf>(3);
+        for (int k = 0; k < PT_ENTRIES; k++) leaf->pte[k] = {true, false, pmd->huge_base[i] + k, 0};
+        pmd->leaf[i] = leaf;
+        pmd->huge_base[i] = -1;
+        pt_stats.huge_splits++;
+    }
+
+    // Victim 페이지 매핑 해제 (Huge Page라면 먼저 분할)
+    void evict(long vpn) {
+        if (is_huge(vpn)) split_huge(vpn);
+        PageEntry& e = pte(vpn);
+        e.valid = false;
+        e.is_swapped = true;
+    }
 };
 
 struct PCB {
@@ -65,92 +241,1454 @@ struct PCB {
     int cpu_burst; int io_burst; int io_remaining;
     int page_fault_count; // 통계 출력하기 위함
     int swap_count;       // 통계 출력하기 위함
-    vector<PageEntry> page_table; 
+    int resident_frames;  // 현재 점유 중인 프레임 수
+    RadixPageTable page_table; 
+
+    // 상주 집합 관리 (--alloc, --load-control)
+    int quota;            // Local Replacement 기준 프레임 수 (local: 균등 분배, pff: Fault 빈도로 조정)
+    bool suspended;       // Load Control로 중단됨 (프레임을 모두 내놓고 run_queue에서 빠짐)
+    deque<long> ws_refs;  // 최근 ws_window번 접근한 VPN
+    unordered_map<long, int> ws_count; // ws_refs 안의 VPN별 등장 횟수
+    int wss;              // Working Set 크기 (ws_refs 안의 서로 다른 페이지 수)
+    long pff_access, pff_faults; // 현재 PFF 측정 구간의 접근/Fault 수
+    mutex pt_lock;        // 멀티 CPU 모드: 다른 CPU가 이 프로세스의 프레임을 빼앗을 때 Page Table 보호
+};
+
+// 프로세스 주소 공간: 서로 멀리 떨어진 4개 영역 (각 영역 시작은 2MB 정렬)
+// 사용 페이지 번호(0 ~ process_pages-1)를 영역별 VPN으로 변환함
+struct Region { long base_vpn; int share; }; // share: 전체 페이지 중 비율 (1/8 단위)
+const Region REGIONS[] = {
+    {0x400000L >> PAGE_SHIFT, 1},           // code
+    {0x10000000L >> PAGE_SHIFT, 4},         // heap
+    {0x7f0000000000L >> PAGE_SHIFT, 2},     // mmap
+    {0x7ffff0000000L >> PAGE_SHIFT, 1},     // stack
+};
+
+long page_to_vpn(int page) {
+    const int n = sizeof(REGIONS) / sizeof(REGIONS[0]);
+    int start = 0;
+    for (int i = 0; i < n - 1; i++) {
+        int size = max(1, process_pages * REGIONS[i].share / 8);
+        if (page < start + size) return REGIONS[i].base_vpn + (page - start);
+        start += size;
+    }
+    return REGIONS[n - 1].base_vpn + (page - start); // 나머지는 stack
+}
+
+// 2-2. Page Replacement Policies
+// 정책은 frame_table 위에서 "어느 프레임을 비울지"만 결정함 (Page Table/Reverse Map 갱신은 커널 담당)
+// key는 (프로세스, 페이지)를 하나로 합친 값으로, 프레임을 떠난 페이지를 기억해야 하는 정책(ARC)이 사용함
+inline long page_key(int pid, long vpn) { return ((long)pid << VPN_BITS) | vpn; }
+
+class ReplacementPolicy {
+public:
+    virtual ~ReplacementPolicy() {}
+    virtual const char* name() const = 0;
+    virtual void on_access(size_t trace_pos) { (void)trace_pos; } // 오프라인 정책(OPT)용 현재 위치
+    virtual void on_hit(int frame) = 0;
+    virtual void on_load(int frame, long key) = 0;
+    // 교체할 프레임을 골라 정책의 관리 목록에서 제거 (incoming_key: 이번에 들어올 페이지)
+    virtual int victim(long incoming_key) = 0;
+    // Local Replacement: owner 프로세스의 프레임 중에서만 골라 제거 (owner는 프레임이 하나 이상 있어야 함)
+    virtual int victim_local(int owner) = 0;
+    // 정책 밖에서 비운 프레임을 관리 목록에서 제거 (Working Set 축소, 프로세스 중단)
+    virtual void remove(int frame) = 0;
+};
+
+extern vector<FrameInfo> frame_table; // 3. Global Variables, Local Replacement에서 프레임 주인 확인용
+inline bool owned_by(int frame, int owner) { return frame_table[frame].pid == owner; }
+
+// FIFO: 가장 먼저 적재된 프레임부터 교체
+class FifoPolicy : public ReplacementPolicy {
+    deque<int> order;
+public:
+    const char* name() const override { return "fifo"; }
+    void on_hit(int) override {}
+    void on_load(int frame, long) override { order.push_back(frame); }
+    int victim(long) override { int f = order.front(); order.pop_front(); return f; }
+    int victim_local(int owner) override {
+        auto it = find_if(order.begin(), order.end(), [&](int f) { return owned_by(f, owner); });
+        int f = *it;
+        order.erase(it);
+        return f;
+    }
+    void remove(int frame) override { order.erase(find(order.begin(), order.end(), frame)); }
+};
+
+// LRU: 접근할 때마다 리스트 맨 뒤로 옮기고 맨 앞(가장 오래 안 쓴 프레임)을 교체
+class LruPolicy : public ReplacementPolicy {
+    list<int> order;
+    vector<list<int>::iterator> pos;
+public:
+    LruPolicy() : pos(total_frames) {}
+    const char* name() const override { return "lru"; }
+    void on_hit(int frame) override { order.splice(order.end(), order, pos[frame]); }
+    void on_load(int frame, long) override { pos[frame] = order.insert(order.end(), frame); }
+    int victim(long) override { int f = order.front(); order.pop_front(); return f; }
+    int victim_local(int owner) override {
+        auto it = find_if(order.begin(), order.end(), [&](int f) { return owned_by(f, owner); });
+        int f = *it;
+        order.erase(it);
+        return f;
+    }
+    void remove(int frame) override { order.erase(pos[frame]); }
+};
+
+// CLOCK (Second Chance): 참조 비트가 켜진 프레임은 비트만 끄고 한 번 더 기회를 줌
+class ClockPolicy : public ReplacementPolicy {
+    vector<char> ref, loaded;
+    int hand = 0;
+public:
+    ClockPolicy() : ref(total_frames, 0), loaded(total_frames, 0) {}
+    const char* name() const override { return "clock"; }
+    void on_hit(int frame) override { ref[frame] = 1; }
+    void on_load(int frame, long) override { loaded[frame] = 1; ref[frame] = 1; }
+    int victim(long) override {
+        while (true) {
+            int f = hand;
+            hand = (hand + 1) % total_frames;
+            if (!loaded[f]) continue;
+            if (ref[f]) { ref[f] = 0; continue; }
+            loaded[f] = 0;
+            return f;
+        }
+    }
+    // 전역 hand 위치부터 자기 프레임만 훑음 (다른 프로세스의 참조 비트는 건드리지 않음)
+    int victim_local(int owner) override {
+        for (int f = hand;; f = (f + 1) % total_frames) {
+            if (!loaded[f] || !owned_by(f, owner)) continue;
+            if (ref[f]) { ref[f] = 0; continue; }
+            loaded[f] = 0;
+            return f;
+        }
+    }
+    void remove(int frame) override { loaded[frame] = 0; }
+};
+
+// LFU: 적재 이후 접근 횟수가 가장 적은 프레임을 교체 (동률이면 먼저 적재된 프레임)
+class LfuPolicy : public ReplacementPolicy {
+    struct Entry { long count; long seq; int frame; };
+    struct Less {
+        bool operator()(const Entry& a, const Entry& b) const {
+            return a.count != b.count ? a.count < b.count : a.seq < b.seq;
+        }
+    };
+    set<Entry, Less> heap;
+    vector<Entry> entry;
+    long seq = 0;
+public:
+    LfuPolicy() : entry(total_frames) {}
+    const char* name() const override { return "lfu"; }
+    void on_hit(int frame) override {
+        heap.erase(entry[frame]);
+        entry[frame].count++;
+        heap.insert(entry[frame]);
+    }
+    void on_load(int frame, long) override {
+        entry[frame] = {1, seq++, frame};
+        heap.insert(entry[frame]);
+    }
+    int victim(long) override {
+        int f = heap.begin()->frame;
+        heap.erase(heap.begin());
+        return f;
+    }
+    int victim_local(int owner) override {
+        auto it = find_if(heap.begin(), heap.end(), [&](const Entry& e) { return owned_by(e.frame, owner); });
+        int f = it->frame;
+        heap.erase(it);
+        return f;
+    }
+    void remove(int frame) override { heap.erase(entry[frame]); }
+};
+
+// ARC (Adaptive Replacement Cache, Megiddo & Modha)
+// T1: 한 번 접근된 페이지, T2: 두 번 이상 접근된 페이지, B1/B2: 각각에서 쫓겨난 페이지 기록(ghost)
+// ghost 적중 방향에 따라 T1 목표 크기 p를 조정해 최근성/빈도 사이를 스스로 맞춤
+class ArcPolicy : public ReplacementPolicy {
+    enum Where { T1, T2, B1, B2 };
+    struct Loc { Where where; list<long>::iterator it; };
+    list<long> lists[4];                // 앞쪽이 LRU
+    unordered_map<long, Loc> index;     // key -> 위치
+    vector<long> frame_key;             // frame -> key
+    unordered_map<long, int> key_frame; // 적재된 key -> frame
+    int c = total_frames;
+    int p = 0;
+
+    void move_to(long key, Where where) {
+        auto found = index.find(key);
+        if (found != index.end()) lists[found->second.where].erase(found->second.it);
+        index[key] = {where, lists[where].insert(lists[where].end(), key)};
+    }
+    void drop_lru(Where where) {
+        long key = lists[where].front();
+        lists[where].pop_front();
+        index.erase(key);
+    }
+    // 적재된 key를 ghost 목록으로 옮기고 프레임을 돌려줌
+    int evict_key(long key, Where from) {
+        move_to(key, from == T1 ? B1 : B2);
+        int f = key_frame[key];
+        key_frame.erase(key);
+        frame_key[f] = -1;
+        return f;
+    }
+public:
+    ArcPolicy() : frame_key(total_frames, -1) {}
+    const char* name() const override { return "arc"; }
+    void on_hit(int frame) override { move_to(frame_key[frame], T2); }
+    void on_load(int frame, long key) override {
+        auto found = index.find(key);
+        Where where = T1;
+        if (found != index.end() && found->second.where == B1) {
+            p = min(c, p + max(1, (int)(lists[B2].size() / max<size_t>(1, lists[B1].size()))));
+            where = T2;
+        } else if (found != index.end() && found->second.where == B2) {
+            p = max(0, p - max(1, (int)(lists[B1].size() / max<size_t>(1, lists[B2].size()))));
+            where = T2;
+        } else {
+            // 처음 보는 페이지: ghost 목록이 전체 2c를 넘지 않도록 정리
+            if (lists[T1].size() + lists[B1].size() >= (size_t)c && !lists[B1].empty()) drop_lru(B1);
+            else if (lists[T1].size() + lists[T2].size() + lists[B1].size() + lists[B2].size() >= (size_t)(2 * c) && !lists[B2].empty()) drop_lru(B2);
+        }
+        move_to(key, where);
+        frame_key[frame] = key;
+        key_frame[key] = frame;
+    }
+    int victim(long incoming_key) override {
+        auto found = index.find(incoming_key);
+        bool in_b2 = found != index.end() && found->second.where == B2;
+        Where from = (!lists[T1].empty() && ((int)lists[T1].size() > p || (in_b2 && (int)lists[T1].size() == p)) ) || lists[T2].empty() ? T1 : T2;
+        return evict_key(lists[from].front(), from);
+    }
+    // T1이 목표 크기 p를 넘으면 T1부터, 아니면 T2부터 owner의 가장 오래된 페이지를 찾음 (key에 pid가 들어 있음)
+    int victim_local(int owner) override {
+        Where first = (int)lists[T1].size() > p ? T1 : T2;
+        for (Where from : {first, first == T1 ? T2 : T1}) {
+            for (long key : lists[from]) {
+                if ((int)(key >> VPN_BITS) == owner) return evict_key(key, from);
+            }
+        }
+        return -1;
+    }
+    // 스스로 내놓은 페이지는 ghost로 남기지 않음
+    void remove(int frame) override {
+        long key = frame_key[frame];
+        auto found = index.find(key);
+        lists[found->second.where].erase(found->second.it);
+        index.erase(found);
+        key_frame.erase(key);
+        frame_key[frame] = -1;
+    }
+};
+
+// OPT (Belady): 다음 사용 시점이 가장 먼 프레임을 교체
+// 미래 접근을 알아야 하므로 기록된 접근 Trace를 재생할 때만 사용 가능
+class OptPolicy : public ReplacementPolicy {
+    const vector<size_t>& next_use; // next_use[i]: i번째 접근과 같은 페이지의 다음 접근 위치
+    set<pair<size_t, int>> by_next; // (다음 사용 시점, frame), 뒤쪽이 교체 대상
+    vector<size_t> frame_next;
+    size_t pos = 0;
+
+    void update(int frame) {
+        by_next.erase({frame_next[frame], frame});
+        frame_next[frame] = next_use[pos];
+        by_next.insert({frame_next[frame], frame});
+    }
+public:
+    explicit OptPolicy(const vector<size_t>& next) : next_use(next), frame_next(total_frames, 0) {}
+    const char* name() const override { return "opt"; }
+    void on_access(size_t trace_pos) override { pos = trace_pos; }
+    void on_hit(int frame) override { update(frame); }
+    void on_load(int frame, long) override { update(frame); }
+    int victim(long) override {
+        auto last = prev(by_next.end());
+        int f = last->second;
+        by_next.erase(last);
+        frame_next[f] = 0;
+        return f;
+    }
+    int victim_local(int owner) override {
+        auto it = find_if(by_next.rbegin(), by_next.rend(), [&](const pair<size_t, int>& e) { return owned_by(e.second, owner); });
+        int f = it->second;
+        by_next.erase(next(it).base());
+        frame_next[f] = 0;
+        return f;
+    }
+    void remove(int frame) override {
+        by_next.erase({frame_next[frame], frame});
+        frame_next[frame] = 0;
+    }
+};
+
+ReplacementPolicy* make_policy(const string& name) {
+    if (name == "fifo") return new FifoPolicy();
+    if (name == "lru") return new LruPolicy();
+    if (name == "clock") return new ClockPolicy();
+    if (name == "lfu") return new LfuPolicy();
+    if (name == "arc") return new ArcPolicy();
+    return nullptr;
+}
+
+// 2-3. TLB (Translation Lookaside Buffer)
+// Set-Associative 구조: (ASID, VPN)을 64비트 태그로 합쳐 한 Set의 Way들을 SSE2로 한꺼번에 비교함
+// ASID 모드는 프로세스가 바뀌어도 항목을 유지하고, Flush 모드는 Context Switch마다 전체를 비움
+enum TlbReplacement { TLB_LRU, TLB_FIFO, TLB_RANDOM };
+
+class Tlb {
+    static constexpr uint64_t INVALID_TAG = ~0ULL;
+    int sets = 0, ways = 0;
+    bool use_asid = true;
+    TlbReplacement repl = TLB_LRU;
+    vector<uint64_t> tags;   // [set * ways + way], 한 Set의 태그가 연속되도록 배치
+    vector<int> frames;
+    vector<uint32_t> stamp;  // LRU: 마지막 사용 시점, FIFO: 적재 시점
+    uint32_t clock = 0;
+    uint32_t rng = 2463534242u;
+
+    uint64_t make_tag(int asid, long vpn) const { return ((uint64_t)(use_asid ? asid : 0) << VPN_BITS) | (uint64_t)vpn; }
+    int set_of(long vpn) const { return (int)(vpn % sets); }
+
+#ifdef __SSE2__
+    // 태그 2개 비교: SSE2에는 64비트 비교가 없으므로 32비트 비교 결과의 상/하위 절반을 AND
+    static int match2(const uint64_t* t, __m128i key) {
+        __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)t), key);
+        eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_movemask_pd(_mm_castsi128_pd(eq));
+    }
+#endif
+
+    // Set 안에서 태그가 같은 Way 찾기 (없으면 -1)
+    int find_way(int set, uint64_t tag) const {
+        const uint64_t* t = &tags[set * ways];
+        int w = 0;
+#ifdef __SSE2__
+        __m128i key = _mm_set1_epi64x((long long)tag);
+        for (; w + 4 <= ways; w += 4) {
+            int mask = match2(t + w, key) | (match2(t + w + 2, key) << 2);
+            if (mask) return w + __builtin_ctz(mask);
+        }
+        for (; w + 2 <= ways; w += 2) {
+            int mask = match2(t + w, key);
+            if (mask) return w + __builtin_ctz(mask);
+        }
+#endif
+        for (; w < ways; w++) {
+            if (t[w] == tag) return w;
+        }
+        return -1;
+    }
+
+public:
+    long hits = 0, misses = 0, flushes = 0, shootdowns = 0;
+
+    bool enabled() const { return sets > 0; }
+    int entries() const { return sets * ways; }
+    int associativity() const { return ways; }
+    const char* mode() const { return use_asid ? "asid" : "flush"; }
+
+    bool configure(int entry_count, int way_count, bool asid, TlbReplacement policy) {
+        if (entry_count == 0) { sets = ways = 0; return true; }
+        if (entry_count < 0 || way_count <= 0 || entry_count % way_count != 0) return false;
+        ways = way_count;
+        sets = entry_count / way_count;
+        use_asid = asid;
+        repl = policy;
+        tags.assign(entry_count, INVALID_TAG);
+        frames.assign(entry_count, -1);
+        stamp.assign(entry_count, 0);
+        return true;
+    }
+
+    bool lookup(int asid, long vpn, int* frame) {
+        int set = set_of(vpn);
+        int w = find_way(set, make_tag(asid, vpn));
+        if (w < 0) { misses++; return false; }
+        hits++;
+        if (repl == TLB_LRU) stamp[set * ways + w] = ++clock;
+        *frame = frames[set * ways + w];
+        return true;
+    }
+
+    void insert(int asid, long vpn, int frame) {
+        int set = set_of(vpn);
+        int base = set * ways;
+        int w = find_way(set, INVALID_TAG);
+        if (w < 0) {
+            if (repl == TLB_RANDOM) {
+                rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+                w = rng % ways;
+            } else {
+                w = 0;
+                for (int i = 1; i < ways; i++) {
+                    if (stamp[base + i] < stamp[base + w]) w = i;
+                }
+            }
+        }
+        tags[base + w] = make_tag(asid, vpn);
+        frames[base + w] = frame;
+        stamp[base + w] = ++clock;
+    }
+
+    // 프레임을 빼앗긴 페이지의 변환 항목 제거 (TLB Shootdown)
+    void invalidate(int asid, long vpn) {
+        int set = set_of(vpn);
+        int w = find_way(set, make_tag(asid, vpn));
+        if (w < 0) return;
+        tags[set * ways + w] = INVALID_TAG;
+        shootdowns++;
+    }
+
+    // Context Switch: ASID 모드에서는 아무것도 하지 않음
+    void on_switch() {
+        if (use_asid) return;
+        fill(tags.begin(), tags.end(), INVALID_TAG);
+        flushes++;
+    }
+};
+
+// 2-4. Swap Device
+// Swap Out된 페이지 내용을 실제 파일에 pread/pwrite로 보관함 (물리 메모리도 프레임당 4KB를 실제로 가짐)
+// 디스크 한 대가 요청을 도착 순서대로 처리한다고 보고 요청마다 완료 시각을 계산함 (지연 + 페이지당 전송 시간)
+// 시뮬레이션 시간은 Tick당 TICK_US 마이크로초
+#define TICK_US 1000
+#define ZERO_FILL_US 1 // 0으로 채운 새 페이지 할당 비용 (Minor Fault)
+
+// 프레임 맨 앞에 기록하는 페이지 내용. Swap In 할 때 주인과 VPN이 맞는지 검증함
+struct PageStamp {
+    int32_t pid;
+    int32_t pad;
+    int64_t vpn;
+    uint64_t version; // 쓰기 접근마다 증가
+};
+
+class SwapDevice {
+    int fd = -1;
+    uint8_t* mem = nullptr;
+    size_t mem_bytes = 0;
+    double busy_until = 0; // 디스크가 다음 요청을 시작할 수 있는 시각 (us)
+    int next_slot = 0;
+
+    // 디스크 큐에 pages 크기의 요청을 넣고 완료 시각을 돌려줌
+    double schedule(int pages, double now) {
+        busy_until = max(busy_until, now) + latency_us + (double)transfer_us * pages;
+        return busy_until;
+    }
+
+public:
+    int latency_us = 5000;  // 요청당 지연 (Seek + 회전)
+    int transfer_us = 100;  // 페이지당 전송 시간
+    long reads = 0, read_pages = 0, writes = 0;
+    long clean_skips = 0;   // Swap 파일에 같은 내용이 있어 Write-back 생략
+    long zero_drops = 0;    // 쓰기 없이 쫓겨난 새 페이지 (기록 없이 버림)
+    long corrupt = 0;       // Swap In 내용 검증 실패
+    double wait_us = 0;     // Demand Swap In 대기 시간 합계
+
+    bool open(const char* path, int frames) {
+        fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+        if (fd < 0) { perror(path); return false; }
+        unlink(path); // 종료 시 자동으로 사라지는 임시 장치
+        mem_bytes = (size_t)frames * PAGE_SIZE;
+        void* p = mmap(NULL, mem_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (p == MAP_FAILED) { perror("mmap"); ::close(fd); fd = -1; return false; }
+        mem = (uint8_t*)p;
+        return true;
+    }
+    void close() {
+        if (fd < 0) return;
+        ::close(fd);
+        munmap(mem, mem_bytes);
+        fd = -1;
+    }
+    bool enabled() const { return fd >= 0; }
+    long slots_used() const { return next_slot; }
+
+    PageStamp* frame(int f) { return (PageStamp*)(mem + (size_t)f * PAGE_SIZE); }
+
+    void zero_fill(int f, int pid, long vpn) {
+        memset(frame(f), 0, PAGE_SIZE);
+        *frame(f) = {pid, 0, vpn, 0};
+    }
+    void touch(int f) { frame(f)->version++; }
+
+    // Dirty 프레임을 Swap 파일에 기록하고 (처음이면 Slot 할당) Slot + 1을 돌려줌
+    // Write-back은 프로세스를 막지 않지만 디스크 큐는 차지함
+    int write_back(int f, int slot, double now) {
+        if (slot == 0) slot = ++next_slot;
+        if (pwrite(fd, frame(f), PAGE_SIZE, (off_t)(slot - 1) * PAGE_SIZE) != PAGE_SIZE) perror("pwrite");
+        schedule(1, now);
+        writes++;
+        return slot;
+    }
+
+    // Slot 내용을 프레임으로 읽고 주인이 맞는지 검증 (완료 시각은 read_done으로 따로 계산)
+    void read_page(int f, int slot, int pid, long vpn) {
+        if (pread(fd, frame(f), PAGE_SIZE, (off_t)(slot - 1) * PAGE_SIZE) != PAGE_SIZE) perror("pread");
+        if (frame(f)->pid != pid || frame(f)->vpn != vpn) corrupt++;
+        read_pages++;
+    }
+    double read_done(int pages, double now) {
+        reads++;
+        return schedule(pages, now);
+    }
+};
+
+// 2-5. Access Batch Transport
+// 기본(msgq)은 실행할 때마다 요청/응답 메시지 한 쌍으로 배치 하나를 주고받음
+// shm 모드는 자식마다 공유 메모리 SPSC 링을 두고, 자식이 커널 요청 없이 배치를 미리 채워 두면 커널은 링 안의 배치를 복사 없이 바로 처리함
+// 접근 패턴은 커널 상태와 무관하므로 자식이 앞서 나가도 결과는 같음 (링이 가득 차면 자식은 futex로 대기)
+enum TransportKind { TRANSPORT_MSGQ, TRANSPORT_SHM };
+
+TransportKind transport = TRANSPORT_MSGQ;
+int batch_size = ACCESS_PER_TICK;   // 한 번 실행될 때 처리하는 접근 수
+
+// head/tail은 배치 단위 카운터이자 futex 대기 주소 (커널은 head, 자식은 tail에서 잠듦)
+struct alignas(64) AccessRing {
+    atomic<uint32_t> head;          // 자식이 채운 배치 수
+    atomic<uint32_t> kernel_waiting;
+    int cpu_burst[RING_BATCHES];    // 배치별 자식의 남은 CPU Burst (대시보드용)
+    alignas(64) atomic<uint32_t> tail; // 커널이 처리한 배치 수
+    atomic<uint32_t> child_waiting;
+    // 뒤에 AccessRec[RING_BATCHES * batch_size]
+};
+
+uint8_t* ring_mem = nullptr;
+size_t ring_stride = 0, ring_bytes = 0;
+int spin_limit = 0;                 // 호스트 코어가 1개면 busy-wait 없이 바로 futex 대기
+
+static void futex_wait(atomic<uint32_t>* addr, uint32_t expected) {
+    // 프로세스 간 공유 메모리이므로 PRIVATE 플래그를 쓰지 않음
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAIT, expected, NULL, NULL, 0);
+}
+
+static void futex_wake(atomic<uint32_t>* addr) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+// value가 바뀔 때까지 대기 (잠들기 전에 waiting을 올려 상대가 깨우는 것을 놓치지 않게 함)
+static void wait_change(atomic<uint32_t>& value, atomic<uint32_t>& waiting, uint32_t seen) {
+    for (int spin = 0; value.load(memory_order_acquire) == seen; spin++) {
+        if (spin < spin_limit) continue;
+        waiting.fetch_add(1, memory_order_seq_cst);
+        if (value.load(memory_order_seq_cst) == seen) futex_wait(&value, seen);
+        waiting.fetch_sub(1, memory_order_seq_cst);
+    }
+}
+
+static void publish(atomic<uint32_t>& value, atomic<uint32_t>& waiting) {
+    value.fetch_add(1, memory_order_seq_cst);
+    if (waiting.load(memory_order_seq_cst) > 0) futex_wake(&value);
+}
+
+AccessRing* access_ring(int pid) { return (AccessRing*)(ring_mem + ring_stride * pid); }
+AccessRec* ring_batch(AccessRing* r, uint32_t seq) {
+    return (AccessRec*)(r + 1) + (size_t)(seq % RING_BATCHES) * batch_size;
+}
+
+bool setup_access_rings(int count) {
+    ring_stride = (sizeof(AccessRing) + sizeof(AccessRec) * RING_BATCHES * batch_size + 63) & ~(size_t)63;
+    ring_bytes = ring_stride * count;
+    void* mem = mmap(NULL, ring_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (mem == MAP_FAILED) { perror("mmap failed"); return false; }
+    ring_mem = (uint8_t*)mem;
+    for (int i = 0; i < count; i++) new (access_ring(i)) AccessRing();
+    spin_limit = (sysconf(_SC_NPROCESSORS_ONLN) > 1) ? SPIN_LIMIT : 0;
+    return true;
+}
+
+void release_access_rings() {
+    if (ring_mem) munmap(ring_mem, ring_bytes);
+    ring_mem = nullptr;
+}
+
+size_t msg_size(int accesses) { return offsetof(MsgBuf, accesses) - sizeof(long) + sizeof(AccessRec) * accesses; }
+
+// 2-6. Reuse Distance & Miss Ratio Curve
+// Mattson Stack 알고리즘: 같은 페이지를 다시 접근하기까지 접근된 서로 다른 페이지 수(재사용 거리) d를 구하면
+// LRU는 프레임이 d개보다 많을 때만 적중하므로, 실행 한 번으로 모든 프레임 수의 Fault 수를 얻음
+// 거리는 "각 페이지의 마지막 접근 시각에만 1"을 둔 Fenwick Tree의 구간 합으로 접근마다 O(log n)에 계산
+// SHARDS(고정 비율): key 해시가 기준 미만인 페이지만 추적하고 거리를 1/R배 해 전체 곡선을 추정
+#define SHARDS_MODULUS (1u << 24)
+
+struct ReuseStack {
+    unordered_map<long, long> last; // key -> 마지막 접근 시각
+    vector<int> tree;               // Fenwick Tree (1부터 사용)
+    long now = 0;
+    vector<long> hist;              // hist[d]: 재사용 거리가 d인 재접근 수
+    long cold = 0;                  // 처음 접근 (프레임 수와 무관하게 Fault)
+    long refs = 0;
+
+    void add(long t, int v) { for (long i = t + 1; i < (long)tree.size(); i += i & -i) tree[i] += v; }
+    long prefix(long t) const { long s = 0; for (long i = t + 1; i > 0; i -= i & -i) s += tree[i]; return s; }
+
+    // 시각이 Tree 크기에 닿으면 살아 있는 마지막 접근 시각만 순서대로 0, 1, 2 ... 로 다시 매김
+    // (Tree 크기는 접근 수가 아니라 서로 다른 페이지 수에 비례)
+    void compact() {
+        vector<pair<long, long>> order; // (시각, key)
+        order.reserve(last.size());
+        for (auto& kv : last) order.push_back({kv.second, kv.first});
+        sort(order.begin(), order.end());
+        tree.assign(max<size_t>(1 << 16, order.size() * 4) + 1, 0);
+        for (size_t i = 0; i < order.size(); i++) { last[order[i].second] = i; add(i, 1); }
+        now = order.size();
+    }
+
+    void access(long key) {
+        refs++;
+        if (now + 1 >= (long)tree.size()) compact();
+        auto it = last.find(key);
+        if (it == last.end()) {
+            cold++;
+            last.emplace(key, now);
+        } else {
+            // 직전 접근 이후에 마지막으로 접근된 페이지 수 = 전체 페이지 수 - 직전 접근 시각까지의 합
+            long d = (long)last.size() - prefix(it->second);
+            if (d >= (long)hist.size()) hist.resize(d + 1, 0);
+            hist[d]++;
+            add(it->second, -1);
+            it->second = now;
+        }
+        add(now, 1);
+        now++;
+    }
+};
+
+class MrcAnalyzer {
+public:
+    double rate = 1.0;     // SHARDS 표본 비율 (1이면 모든 페이지를 추적하는 정확한 계산)
+    long total_refs = 0;   // 표본 여부와 무관한 전체 접근 수
+    ReuseStack all;        // 전체 프로세스를 합친 접근 (key = page_key)
+    vector<ReuseStack> procs;
+
+    void init(int process_count, double r) {
+        rate = r;
+        threshold = (uint64_t)(r * SHARDS_MODULUS);
+        procs.assign(process_count, ReuseStack());
+    }
+    bool enabled() const { return !procs.empty(); }
+
+    void access(int pid, long key) {
+        total_refs++;
+        if (rate < 1.0 && mix(key) % SHARDS_MODULUS >= threshold) return;
+        all.access(key);
+        procs[pid].access(key);
+    }
+
+    // 표본 거리 d -> 전체 기준 추정 거리
+    long scaled(size_t d) const { return (long)(d / rate); }
+
+    // miss[c]: 프레임 c개 (0 ~ max_frames)일 때 LRU Miss Ratio
+    vector<double> miss_curve(const ReuseStack& s, int max_frames) const {
+        vector<long> hits_at(max_frames + 1, 0); // 추정 거리가 e인 재접근 수 (프레임이 e개보다 많으면 적중)
+        for (size_t d = 0; d < s.hist.size(); d++) {
+            long e = scaled(d);
+            if (e < max_frames) hits_at[e] += s.hist[d];
+        }
+        vector<double> miss(max_frames + 1, 1.0);
+        long hits = 0;
+        for (int c = 1; c <= max_frames; c++) {
+            hits += hits_at[c - 1];
+            miss[c] = s.refs ? (double)(s.refs - hits) / s.refs : 0.0;
+        }
+        if (!s.refs) miss[0] = 0.0;
+        return miss;
+    }
+
+    // 모든 재접근이 적중하는 최소 프레임 수 (곡선이 더 내려가지 않는 지점)
+    int curve_end() const {
+        long end = scaled(all.hist.size()) + 1;
+        for (const ReuseStack& s : procs) end = max(end, scaled(s.hist.size()) + 1);
+        return (int)min<long>(end, INT_MAX - 1);
+    }
+
+private:
+    uint64_t threshold = SHARDS_MODULUS;
+    static uint64_t mix(uint64_t x) { // splitmix64 finalizer
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
 };
 
 // 3. Global Variables (Kernel State)
 
 // Memory Management
-deque<int> free_frame_list;         // 초기 빈 프레임 리스트
-deque<int> active_frames_queue;     // [FIFO Logic] 할당된 프레임 순서 관리
-FrameInfo frame_table[TOTAL_FRAMES];// [Reverse Map] 프레임별 소유자 정보
+// 빈 프레임 관리: 4KB는 낮은 번호부터, 2MB는 512개가 모두 비어 있는 정렬된 블록 단위로 할당
+// (Replacement로 회수한 프레임은 바로 다시 할당되고, 상주 집합 축소/프로세스 중단으로 비운 프레임만 목록으로 돌아옴)
+struct FreeFrameList {
+    vector<char> is_free;
+    vector<int> block_free;  // 2MB 블록별 빈 프레임 수
+    int count = 0;
+    int cursor = 0;
+
+    void init(int frames) {
+        is_free.assign(frames, 1);
+        block_free.assign((frames + HUGE_PAGES - 1) / HUGE_PAGES, 0);
+        for (int i = 0; i < frames; i++) block_free[i / HUGE_PAGES]++;
+        count = frames;
+        cursor = 0;
+    }
+    bool empty() const { return count == 0; }
+    void take(int f) { is_free[f] = 0; block_free[f / HUGE_PAGES]--; count--; }
+    void push(int f) {
+        is_free[f] = 1;
+        block_free[f / HUGE_PAGES]++;
+        count++;
+        cursor = min(cursor, f);
+    }
+    int pop() {
+        while (!is_free[cursor]) cursor++;
+        take(cursor);
+        return cursor;
+    }
+    // 연속된 512 프레임의 시작 번호 (없으면 -1)
+    int pop_block() {
+        for (size_t b = 0; b < block_free.size(); b++) {
+            if (block_free[b] != HUGE_PAGES) continue;
+            for (int k = 0; k < HUGE_PAGES; k++) take(b * HUGE_PAGES + k);
+            return b * HUGE_PAGES;
+        }
+        return -1;
+    }
+};
+
+FreeFrameList free_frame_list;      // 빈 프레임 목록
+ReplacementPolicy* replacer;        // 교체 정책 (할당된 프레임 순서/참조 정보 관리)
+vector<FrameInfo> frame_table;      // [Reverse Map] 프레임별 소유자 정보
+vector<long> access_trace;          // 실행 중 발생한 접근 기록 (page_key), 정책 비교 재생용
+MrcAnalyzer mrc;                    // 재사용 거리 / LRU Miss Ratio Curve 분석 (--mrc)
+string mrc_prefix;                  // CSV 파일 이름 앞부분
 
 // System Statistics
 long total_page_faults = 0;
 long total_swap_outs = 0;
 long total_access = 0;
+long total_page_walks = 0;          // TLB Miss 후 Page Table 조회 횟수
+long context_switches = 0;
+long walk_levels = 0;               // Page Walk에서 읽은 테이블 단계 수 합계
+
+// Swap
+SwapDevice swap_dev;
+string swap_path = "vm_swap.img";
+int prefetch_pages = 0;             // Swap In 할 때 함께 읽을 뒤쪽 페이지 수 (Read-ahead)
+int mem_latency_ns = 100;           // 메모리 접근 시간 (EAT 계산용)
+long major_faults = 0;              // Swap 파일에서 읽어 온 Fault
+long prefetch_loads = 0, prefetch_hits = 0;
+long idle_ticks = 0;                // 모든 프로세스가 Swap In을 기다려 CPU가 논 Tick
+
+// Resident Set Management
+enum AllocMode {
+    ALLOC_GLOBAL, // 모든 프레임 중에서 교체 (기본값)
+    ALLOC_LOCAL,  // 프레임을 균등 분배하고 자기 프레임 안에서만 교체
+    ALLOC_WS,     // Working Set 모델: 최근 ws_window번 접근에서 빠진 페이지는 즉시 반납
+    ALLOC_PFF     // Page Fault Frequency: Fault 비율이 높으면 할당을 늘리고 낮으면 줄임
+};
+AllocMode alloc_mode = ALLOC_GLOBAL;
+int ws_window = 500;                // Working Set Window (프로세스 자신의 접근 수)
+int pff_low = 2, pff_high = 10;     // PFF 하한/상한 (%)
+int pff_interval = 100;             // PFF 측정 구간 (접근 수)
+bool load_control = false;          // 전체 요구량이 프레임 수를 넘으면 프로세스 중단
+int fault_window = 0;               // 구간별 Fault 비율 표의 구간 길이 (Tick, 0이면 출력 안 함)
+long ws_releases = 0, pff_grows = 0, pff_shrinks = 0, suspensions = 0, resumes = 0;
+vector<vector<long>> win_access, win_faults; // [구간][프로세스]
+vector<int> win_suspended;                   // 구간 중 최대 중단 프로세스 수
+
+// Shared Pages & Copy-on-Write
+vector<int> shared_frame;           // 공유 영역 페이지 -> 프레임 (-1이면 메모리에 없음, Page Cache 역할)
+int fork_tick = -1;                 // 이 Tick에 P0을 fork해 나머지 프로세스를 만듦 (-1이면 모두 처음부터 독립 실행)
+long shared_maps = 0;               // 다른 프로세스가 올려 둔 공유 페이지를 매핑만 한 Fault
+long cow_inherited = 0, cow_copies = 0;
+struct ShareStats {
+    long rss_sum;         // 프로세스별 상주 페이지 수 합 (공유 프레임은 매핑마다 셈)
+    long frames_used;     // 실제로 쓰는 프레임 수
+    long shared_resident; // 메모리에 있는 공유 영역 페이지
+    long shared_mappings; // 그 페이지들의 매핑 수 합
+    long cow_shared;      // 아직 복사되지 않고 함께 매핑된 fork 페이지
+};
+ShareStats share_stats;             // 종료 시점 (run_kernel 끝에서 채움)
+
+// TLB
+Tlb tlb;
 
-// IPC & Log
+// IPC
 int q1_id, q2_id; 
-FILE* log_fp; 
 
 // Visualization State
 int last_victim_frame = -1; 
+int sim_ticks = SIMULATION_TICKS;
+bool headless = false;              // 대시보드와 Tick 지연 없이 최대 속도로 실행
+int tick_delay_ms = 100;            // 대화형 모드의 Tick당 지연 (시뮬레이션 속도)
+int refresh_ms = 200;               // 대시보드 갱신 주기 (화면 속도)
+bool compare_policies = false;
 string last_battle_log = "System Initialized... Waiting for Requests.";
 
-// 4. Helper Functions
+// 4. Access Trace (Logging)
+// 커널은 접근/Fault 이벤트를 고정 크기 레코드로 Tick 단위 묶음에 담아 링 버퍼에 넘기기만 함
+// 문자열 생성과 파일 기록은 백그라운드 스레드가 담당 (텍스트 로그와 --decode는 같은 렌더러 사용)
+enum LogMode {
+    LOG_TEXT,   // vm_final_dump.txt (기본값)
+    LOG_BINARY, // vm_final_dump.bin (--compress면 delta + varint 인코딩)
+    LOG_NONE
+};
+
+enum LogLevel {
+    LEVEL_NONE,  // 기록 안 함
+    LEVEL_FAULT, // Page Fault만 기록 (Hit은 통계로만 집계)
+    LEVEL_ALL    // 모든 접근 기록 (기본값)
+};
+
+enum TraceType : uint8_t {
+    REC_HIT = 1,     // Page Table 조회로 변환
+    REC_TLB_HIT,     // TLB에서 변환
+    REC_FAULT_NEW,   // 빈 프레임 할당
+    REC_FAULT_SWAP,  // victim = 쫓겨난 프로세스
+    REC_FAULT_HUGE,  // 2MB Huge Page 할당
+    REC_FAULT_SHARED,// 이미 올라온 공유 영역 프레임을 매핑
+    REC_FAULT_COW    // 쓰기 시 복사 (frame = 새 프레임)
+};
+
+struct TraceRec {
+    uint8_t type;
+    uint8_t reserved[3];
+    int32_t tick;
+    int32_t pid;
+    int32_t frame;
+    int64_t vpn;
+    int32_t victim;
+    int32_t pad;
+};
+
+#define TRACE_MAGIC "T2TRACE1"
+#define TRACE_FLAG_COMPRESSED 1
+#define TRACE_RING_SIZE (1 << 16) // 레코드 수 (2의 거듭제곱)
+
+LogMode log_mode = LOG_TEXT;
+LogLevel log_level = LEVEL_ALL;
+bool compress_trace = false;
+
+static void append_fmt(string& out, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+static void append_fmt(string& out, const char* fmt, ...) {
+    char line[256];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(line, sizeof(line), fmt, ap);
+    va_end(ap);
+    out.append(line, min(n, (int)sizeof(line) - 1));
+}
+
+// 레코드 -> 텍스트 한 줄
+void render_record(const TraceRec& r, string& out) {
+    append_fmt(out, "[Tick %d] [P%d %s] ", r.tick, r.pid, P_EMOJIS[r.pid % 10].c_str());
+    switch (r.type) {
+        case REC_HIT:        append_fmt(out, "Access VA:0x%lx -> PA:%d (Hit)\n", (long)r.vpn << PAGE_SHIFT, r.frame); break;
+        case REC_TLB_HIT:    append_fmt(out, "Access VA:0x%lx -> PA:%d (TLB Hit)\n", (long)r.vpn << PAGE_SHIFT, r.frame); break;
+        case REC_FAULT_NEW:  out += "Page Fault & New Alloc\n"; break;
+        case REC_FAULT_SWAP: append_fmt(out, "Page Fault & Swap Out P%d\n", r.victim); break;
+        case REC_FAULT_HUGE: out += "Page Fault & Huge Page Alloc (2MB)\n"; break;
+        case REC_FAULT_SHARED: append_fmt(out, "Page Fault & Map Shared PA:%d\n", r.frame); break;
+        case REC_FAULT_COW:  append_fmt(out, "Write Fault & COW Copy -> PA:%d\n", r.frame); break;
+        default:             append_fmt(out, "Unknown record %d\n", r.type); break;
+    }
+}
+
+// 압축 형식: type, tick 증가분, pid, 같은 프로세스 직전 VPN과의 차이(zigzag), frame, (victim + 1) 을 각각 varint로 기록
+struct TraceCodec {
+    int32_t last_tick = 0;
+    unordered_map<int32_t, int64_t> last_vpn;
+
+    static void put_varint(vector<uint8_t>& out, uint64_t v) {
+        while (v >= 0x80) { out.push_back((uint8_t)(v | 0x80)); v >>= 7; }
+        out.push_back((uint8_t)v);
+    }
+    static bool get_varint(const uint8_t*& p, const uint8_t* end, uint64_t* v) {
+        *v = 0;
+        for (int shift = 0; p < end && shift < 64; shift += 7) {
+            uint8_t b = *p++;
+            *v |= (uint64_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+    static uint64_t zigzag(int64_t v) { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+    static int64_t unzigzag(uint64_t v) { return (int64_t)(v >> 1) ^ -(int64_t)(v & 1); }
+
+    void encode(const TraceRec& r, vector<uint8_t>& out) {
+        out.push_back(r.type);
+        put_varint(out, (uint32_t)(r.tick - last_tick));
+        put_varint(out, (uint32_t)r.pid);
+        int64_t& prev = last_vpn[r.pid];
+        put_varint(out, zigzag(r.vpn - prev));
+        put_varint(out, (uint32_t)r.frame);
+        if (r.type == REC_FAULT_SWAP) put_varint(out, (uint32_t)(r.victim + 1));
+        last_tick = r.tick;
+        prev = r.vpn;
+    }
+
+    // 레코드 1개 복원 (입력이 부족하면 false, p는 그대로)
+    bool decode(const uint8_t*& p, const uint8_t* end, TraceRec* r) {
+        const uint8_t* q = p;
+        uint64_t tick_delta, pid, vpn_delta, frame, victim = 0;
+        if (q >= end) return false;
+        uint8_t type = *q++;
+        if (!get_varint(q, end, &tick_delta) || !get_varint(q, end, &pid) || !get_varint(q, end, &vpn_delta) ||
+            !get_varint(q, end, &frame)) return false;
+        if (type == REC_FAULT_SWAP && !get_varint(q, end, &victim)) return false;
+
+        *r = TraceRec();
+        r->type = type;
+        r->tick = last_tick + (int32_t)tick_delta;
+        r->pid = (int32_t)pid;
+        int64_t& prev = last_vpn[r->pid];
+        r->vpn = prev + unzigzag(vpn_delta);
+        r->frame = (int32_t)frame;
+        r->victim = (int32_t)victim - 1;
+        last_tick = r->tick;
+        prev = r->vpn;
+        p = q;
+        return true;
+    }
+};
+
+// 단일 생산자(커널)/단일 소비자(기록 스레드) 링 버퍼
+struct TraceWriter {
+    TraceRec* buf = nullptr;
+    atomic<size_t> head{0};
+    atomic<size_t> tail{0};
+    atomic<bool> stop{false};
+    FILE* fp = nullptr;
+    thread worker;
+    TraceCodec codec;
+    long bytes_written = 0;
+
+    void start(FILE* out) {
+        fp = out;
+        buf = new TraceRec[TRACE_RING_SIZE];
+        if (log_mode == LOG_BINARY) {
+            uint8_t flags = compress_trace ? TRACE_FLAG_COMPRESSED : 0;
+            fwrite(TRACE_MAGIC, 1, 8, fp);
+            fwrite(&flags, 1, 1, fp);
+            bytes_written = 9;
+        }
+        worker = thread(&TraceWriter::drain, this);
+    }
+
+    void push(const TraceRec* recs, size_t n) {
+        size_t h = head.load(memory_order_relaxed);
+        for (size_t i = 0; i < n; ++i) {
+            while (h - tail.load(memory_order_acquire) >= TRACE_RING_SIZE) {
+                head.store(h, memory_order_release); // 가득 차면 지금까지 쓴 것을 먼저 넘김
+                sched_yield();
+            }
+            buf[h & (TRACE_RING_SIZE - 1)] = recs[i];
+            h++;
+        }
+        head.store(h, memory_order_release);
+    }
+
+    // 링 경계를 넘지 않는 연속 구간 단위로 변환해 기록
+    void write_span(const TraceRec* r, size_t n) {
+        if (log_mode == LOG_BINARY && !compress_trace) {
+            fwrite(r, sizeof(TraceRec), n, fp);
+            bytes_written += sizeof(TraceRec) * n;
+            return;
+        }
+        static string text;
+        static vector<uint8_t> packed;
+        text.clear();
+        packed.clear();
+        for (size_t i = 0; i < n; ++i) {
+            if (log_mode == LOG_TEXT) render_record(r[i], text);
+            else codec.encode(r[i], packed);
+        }
+        if (log_mode == LOG_TEXT) { fwrite(text.data(), 1, text.size(), fp); bytes_written += text.size(); }
+        else { fwrite(packed.data(), 1, packed.size(), fp); bytes_written += packed.size(); }
+    }
+
+    void drain() {
+        while (true) {
+            size_t t = tail.load(memory_order_relaxed);
+            size_t h = head.load(memory_order_acquire);
+            if (h == t) {
+                if (stop.load(memory_order_acquire) && head.load(memory_order_acquire) == t) break;
+                usleep(500);
+                continue;
+            }
+            size_t begin = t & (TRACE_RING_SIZE - 1);
+            size_t len = min(h - t, TRACE_RING_SIZE - begin);
+            write_span(&buf[begin], len);
+            tail.store(t + len, memory_order_release);
+        }
+    }
+
+    void finish() {
+        if (!worker.joinable()) return;
+        stop.store(true, memory_order_release);
+        worker.join();
+        delete[] buf;
+        buf = nullptr;
+    }
+};
+
+TraceWriter trace_writer;
+vector<TraceRec> tick_records; // 현재 Tick에서 모은 레코드 (Tick 끝에 한 번에 넘김)
 
-void log_event(int tick, int pid, string msg) {
-    char buffer[256];
-    snprintf(buffer, sizeof(buffer), "[Tick %d] [P%d %s] %s\n", tick, pid, P_EMOJIS[pid].c_str(), msg.c_str());
-    fprintf(log_fp, "%s", buffer);
+inline void trace_event(TraceType type, int tick, int pid, long vpn, int frame, int victim = -1) {
+    bool is_fault = type >= REC_FAULT_NEW;
+    if (log_mode == LOG_NONE || log_level == LEVEL_NONE || (log_level == LEVEL_FAULT && !is_fault)) return;
+    TraceRec r = {};
+    r.type = type;
+    r.tick = tick;
+    r.pid = pid;
+    r.frame = frame;
+    r.vpn = vpn;
+    r.victim = victim;
+    tick_records.push_back(r);
 }
 
-// System Dashboard & Visual Map
-void print_system_status(int tick, PCB* pcb_table[]) {
-    system("clear"); 
+void flush_trace() {
+    if (tick_records.empty()) return;
+    trace_writer.push(tick_records.data(), tick_records.size());
+    tick_records.clear();
+}
+
+// 바이너리 Trace -> 텍스트 (vm_final_dump.txt와 같은 형식으로 stdout에 출력)
+int decode_trace(const char* path) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) { perror("fopen"); return 1; }
+
+    char magic[8];
+    uint8_t flags;
+    if (fread(magic, 1, 8, fp) != 8 || memcmp(magic, TRACE_MAGIC, 8) != 0 || fread(&flags, 1, 1, fp) != 1) {
+        fprintf(stderr, "%s: not a term2 binary trace\n", path);
+        fclose(fp);
+        return 1;
+    }
+
+    string text;
+    if (!(flags & TRACE_FLAG_COMPRESSED)) {
+        vector<TraceRec> chunk(4096);
+        size_t n;
+        while ((n = fread(chunk.data(), sizeof(TraceRec), chunk.size(), fp)) > 0) {
+            text.clear();
+            for (size_t i = 0; i < n; ++i) render_record(chunk[i], text);
+            fwrite(text.data(), 1, text.size(), stdout);
+        }
+    } else {
+        TraceCodec codec;
+        vector<uint8_t> data(1 << 16);
+        size_t have = 0, n;
+        TraceRec r;
+        while ((n = fread(data.data() + have, 1, data.size() - have, fp)) > 0 || have > 0) {
+            have += n;
+            const uint8_t* p = data.data();
+            const uint8_t* end = p + have;
+            text.clear();
+            while (codec.decode(p, end, &r)) render_record(r, text);
+            fwrite(text.data(), 1, text.size(), stdout);
+            size_t used = p - data.data();
+            if (used == 0 && n == 0) break; // 끝부분이 잘린 레코드
+            memmove(data.data(), p, have - used);
+            have -= used;
+        }
+    }
+    fclose(fp);
+    return 0;
+}
+
+// 4-1. System Dashboard & Visual Map
+// 커널은 Tick마다 상태 Snapshot만 넘기고, 별도 스레드가 고정 주기로 화면을 그림
+// 직전 화면과 줄 단위로 비교해 바뀐 줄만 ANSI 커서 이동으로 다시 출력함 (system("clear") 없음)
+struct DashboardSnapshot {
+    int tick;
+    long page_faults, swap_outs, access;
+    long tlb_hits, page_walks, shootdowns;
+    int used_frames;
+    int victim_cell;
+    int shown_procs;
+    vector<int> cell_owner;             // 지도 한 칸 = frames_per_cell개 프레임 (첫 프레임의 소유자)
+    int cpu_burst[DASHBOARD_PROCS];
+    int fault_count[DASHBOARD_PROCS];
+    int resident[DASHBOARD_PROCS];
+    string battle_log;
+};
+
+vector<string> build_screen(const DashboardSnapshot& s) {
+    vector<string> lines;
+    char buf[512];
 
     // 1. Calculate Stats
-    int used_frames = active_frames_queue.size();
-    double mem_usage = (double)used_frames / TOTAL_FRAMES * 100.0;
-    
+    double mem_usage = (double)s.used_frames / total_frames * 100.0;
+
     // 2. Top Header (System Monitor Style)
-    printf("┌──────────────────────────────────────────────────────────────┐\n");
-    printf("│ OS SYSTEM MONITOR (Term Project #2)                          │\n");
-    printf("├─────────────────┬──────────────────────┬─────────────────────┤\n");
-    printf("│ Tick: %-9d │ Mem: %3d/%-3d (%4.1f%%) │ P.Faults: %-8ld  │\n", 
-            tick, used_frames, TOTAL_FRAMES, mem_usage, total_page_faults);
-    printf("│ Swap Outs: %-5ld│ FIFO Queue: %-7lu  │ Access: %-9ld   │\n",
-            total_swap_outs, active_frames_queue.size(), total_access);
-    printf("└─────────────────┴──────────────────────┴─────────────────────┘\n");
+    lines.push_back("┌──────────────────────────────────────────────────────────────┐");
+    lines.push_back("│ OS SYSTEM MONITOR (Term Project #2)                          │");
+    lines.push_back("├─────────────────┬──────────────────────┬─────────────────────┤");
+    snprintf(buf, sizeof(buf), "│ Tick: %-9d │ Mem: %3d/%-3d (%4.1f%%) │ P.Faults: %-8ld  │",
+             s.tick, s.used_frames, total_frames, mem_usage, s.page_faults);
+    lines.push_back(buf);
+    snprintf(buf, sizeof(buf), "│ Swap Outs: %-5ld│ Policy: %-11s  │ Access: %-9ld   │",
+             s.swap_outs, replacer->name(), s.access);
+    lines.push_back(buf);
+    if (tlb.enabled()) {
+        long lookups = s.tlb_hits + s.page_walks;
+        snprintf(buf, sizeof(buf), "│ TLB Hit: %5.1f%% │ Page Walks: %-8ld │ Shootdowns: %-7ld │",
+                 lookups ? s.tlb_hits * 100.0 / lookups : 0.0, s.page_walks, s.shootdowns);
+        lines.push_back(buf);
+    }
+    lines.push_back("└─────────────────┴──────────────────────┴─────────────────────┘");
 
     // 3. Visual Memory Map
-    printf("\n==== Physical Memory Map (FIFO) ====\n");
-    for (int i = 0; i < TOTAL_FRAMES; i++) {
-        if (i == last_victim_frame) cout << "💥"; 
-        else if (frame_table[i].pid == -1) cout << "⬜"; 
-        else cout << P_EMOJIS[frame_table[i].pid];
-        
-        if ((i + 1) % 32 == 0) cout << endl; 
+    lines.push_back("");
+    snprintf(buf, sizeof(buf), "==== Physical Memory Map (%s) ====", replacer->name());
+    lines.push_back(buf);
+    string row;
+    for (int i = 0; i < (int)s.cell_owner.size(); i++) {
+        if (i == s.victim_cell) row += "💥";
+        else if (s.cell_owner[i] == -1) row += "⬜";
+        else row += P_EMOJIS[s.cell_owner[i] % 10];
+
+        if ((i + 1) % 32 == 0) { lines.push_back(row); row.clear(); }
     }
+    if (!row.empty()) lines.push_back(row);
 
     // 4. Process Dashboard (Detailed)
-    printf("\n==== Process Status Board ====\n");
-    printf("%-4s %-4s %-10s %-10s %-20s\n", "PID", "Sym", "CPU-Burst", "Faults", "Memory Share");
-    printf("------------------------------------------------------------\n");
-    
-    // Count frames per process
-    int counts[PROCESS_COUNT] = {0};
-    for(int i=0; i<TOTAL_FRAMES; i++) {
-        if(frame_table[i].pid != -1) counts[frame_table[i].pid]++;
-    }
+    lines.push_back("");
+    lines.push_back("==== Process Status Board ====");
+    snprintf(buf, sizeof(buf), "%-4s %-4s %-10s %-10s %-20s", "PID", "Sym", "CPU-Burst", "Faults", "Memory Share");
+    lines.push_back(buf);
+    lines.push_back("------------------------------------------------------------");
 
-    for(int i=0; i<PROCESS_COUNT; i++) {
-        PCB* p = pcb_table[i];
+    for (int i = 0; i < s.shown_procs; i++) {
         string bar = "";
-        int bars = counts[i] / 4; 
-        for(int b=0; b<bars; b++) bar += "█";
-        
-        printf("P%-3d %s  %-10d %-10d %-3d frames %s\n", 
-            i, P_EMOJIS[i].c_str(), p->cpu_burst, p->page_fault_count, counts[i], bar.c_str());
+        int bars = (int)((long)s.resident[i] * 128 / total_frames); // 512 프레임 기준 4프레임당 1칸
+        for (int b = 0; b < bars; b++) bar += "█";
+
+        snprintf(buf, sizeof(buf), "P%-3d %s  %-10d %-10d %-3d frames %s",
+                 i, P_EMOJIS[i % 10].c_str(), s.cpu_burst[i], s.fault_count[i], s.resident[i], bar.c_str());
+        lines.push_back(buf);
+    }
+    if (process_count > s.shown_procs) {
+        snprintf(buf, sizeof(buf), "... (%d more processes)", process_count - s.shown_procs);
+        lines.push_back(buf);
     }
 
     // 5. Battle Log
-    printf("------------------------------------------------------------\n");
-    printf("%s\n", last_battle_log.c_str());
-    printf("------------------------------------------------------------\n");
+    lines.push_back("------------------------------------------------------------");
+    lines.push_back(s.battle_log);
+    lines.push_back("------------------------------------------------------------");
+    return lines;
+}
+
+class Dashboard {
+    mutex mtx;
+    DashboardSnapshot shared;   // 커널이 마지막으로 넘긴 상태 (mtx로 보호)
+    bool has_update = false;
+    atomic<bool> running{false};
+    thread worker;
+    vector<string> screen;      // 현재 터미널에 그려져 있는 줄
+    int refresh_ms = 200;
+
+    void render(const DashboardSnapshot& snap) {
+        vector<string> lines = build_screen(snap);
+        string out;
+        if (screen.empty()) out += "\033[2J"; // 첫 화면만 전체 지움
+        for (size_t i = 0; i < lines.size(); i++) {
+            if (i < screen.size() && screen[i] == lines[i]) continue;
+            out += "\033[" + to_string(i + 1) + ";1H" + lines[i] + "\033[K";
+        }
+        for (size_t i = lines.size(); i < screen.size(); i++) out += "\033[" + to_string(i + 1) + ";1H\033[K";
+        out += "\033[" + to_string(lines.size() + 1) + ";1H";
+        fwrite(out.data(), 1, out.size(), stdout);
+        fflush(stdout);
+        screen.swap(lines);
+    }
+
+    void loop() {
+        DashboardSnapshot local;
+        while (running.load(memory_order_acquire)) {
+            this_thread::sleep_for(chrono::milliseconds(refresh_ms));
+            bool fresh = false;
+            {
+                lock_guard<mutex> lock(mtx);
+                if (has_update) { local = shared; has_update = false; fresh = true; }
+            }
+            if (fresh) render(local);
+        }
+    }
+
+public:
+    void start(int refresh) {
+        refresh_ms = refresh;
+        printf("\033[?25l"); // 커서 숨김
+        running.store(true, memory_order_release);
+        worker = thread(&Dashboard::loop, this);
+    }
+
+    // 커널 쪽: Tick 종료 시 현재 상태를 복사해 넘김 (화면 출력은 하지 않음)
+    void publish(int tick, const vector<PCB*>& pcb_table) {
+        lock_guard<mutex> lock(mtx);
+        shared.tick = tick;
+        shared.page_faults = total_page_faults;
+        shared.swap_outs = total_swap_outs;
+        shared.access = total_access;
+        shared.tlb_hits = tlb.hits;
+        shared.page_walks = total_page_walks;
+        shared.shootdowns = tlb.shootdowns;
+        shared.used_frames = total_frames - free_frame_list.count;
+        // 지도는 최대 512칸으로 축약
+        int per_cell = (total_frames + 511) / 512;
+        shared.cell_owner.resize((total_frames + per_cell - 1) / per_cell);
+        for (size_t c = 0; c < shared.cell_owner.size(); c++) shared.cell_owner[c] = frame_table[c * per_cell].pid;
+        shared.victim_cell = last_victim_frame >= 0 ? last_victim_frame / per_cell : -1;
+        shared.shown_procs = min(process_count, DASHBOARD_PROCS);
+        for (int i = 0; i < shared.shown_procs; i++) {
+            shared.cpu_burst[i] = pcb_table[i]->cpu_burst;
+            shared.fault_count[i] = pcb_table[i]->page_fault_count;
+            shared.resident[i] = pcb_table[i]->resident_frames;
+        }
+        shared.battle_log = last_battle_log;
+        has_update = true;
+        last_victim_frame = -1; // Reset effect
+    }
+
+    // 스레드를 멈추고 마지막 상태를 한 번 더 그림
+    void stop() {
+        if (!running.exchange(false)) return;
+        worker.join();
+        if (has_update) render(shared);
+        printf("\033[?25h"); // 커서 복원
+        fflush(stdout);
+    }
+};
+
+Dashboard dashboard;
+
+// 4-2. Workload Generators
+// 사용자 프로세스가 Tick마다 만들어 내는 접근 패턴. 합성 패턴은 페이지 번호(0 ~ process_pages-1)를 골라
+// page_to_vpn으로 영역에 배치하고, trace는 파일의 실제 주소를 그대로 VPN으로 씀
+enum WorkloadType {
+    WL_UNIFORM,     // 전 범위 균등 (기본값, 지역성 없음)
+    WL_WORKING_SET, // Phase마다 바뀌는 Working Set 안에서 대부분 접근
+    WL_ZIPF,        // 소수의 Hot Page에 치우친 접근
+    WL_SEQUENTIAL,  // 임의 위치에서 시작하는 순차 Scan
+    WL_LOOP,        // 고정 범위를 반복해서 순회
+    WL_TRACE        // valgrind lackey / perf 주소 Trace 재생
+};
+
+struct WorkloadConfig {
+    WorkloadType type = WL_UNIFORM;
+    int ws_size = 0;        // Working Set 크기 (0이면 process_pages / 10)
+    int ws_phase = 2000;    // Phase 길이 (접근 수)
+    int ws_locality = 90;   // Working Set 안을 접근할 확률 (%)
+    double zipf_s = 0.99;   // Zipf 지수
+    int write_pct = 30;     // 쓰기 접근 비율 (%)
+    int scan_run = 64;      // 순차 Scan 한 번의 길이
+    int loop_len = 0;       // Loop 길이 (0이면 process_pages)
+    int shared_pages = 0;   // 공유 영역 페이지 수 (0이면 없음)
+    int shared_pct = 20;    // 공유 영역 접근 비율 (%)
+    string trace_path;
+};
+
+WorkloadConfig workload;
+
+inline double rand_unit() { return rand() / (RAND_MAX + 1.0); }
+
+class AccessGenerator {
+public:
+    virtual ~AccessGenerator() {}
+    virtual long next_vpn() = 0;
+    // 직전 접근이 쓰기인지 (합성 패턴은 write_pct 비율로 무작위)
+    virtual bool last_write() { return rand() % 100 < workload.write_pct; }
+};
+
+class UniformGenerator : public AccessGenerator {
+public:
+    long next_vpn() override { return page_to_vpn(rand() % process_pages); }
+};
+
+class WorkingSetGenerator : public AccessGenerator {
+    int size, phase, locality, base = 0, left = 0;
+public:
+    WorkingSetGenerator(const WorkloadConfig& c)
+        : size(min(process_pages, c.ws_size > 0 ? c.ws_size : max(1, process_pages / 10))),
+          phase(max(1, c.ws_phase)), locality(c.ws_locality) {}
+    long next_vpn() override {
+        if (left-- <= 0) { base = rand() % process_pages; left = phase - 1; } // Phase 전환
+        if (rand() % 100 >= locality) return page_to_vpn(rand() % process_pages);
+        return page_to_vpn((base + rand() % size) % process_pages);
+    }
+};
+
+// 순위 r(1부터)의 확률이 1/r^s에 비례. 누적 분포를 미리 만들어 두고 이진 탐색으로 샘플링
+// Hot Page가 한 영역에 몰리지 않도록 순위 -> 페이지 대응은 프로세스마다 섞음
+class ZipfGenerator : public AccessGenerator {
+    vector<double> cdf;
+    vector<int> rank_page;
+public:
+    ZipfGenerator(double s) : cdf(process_pages), rank_page(process_pages) {
+        double sum = 0;
+        for (int r = 0; r < process_pages; r++) cdf[r] = (sum += 1.0 / pow(r + 1, s));
+        for (int r = 0; r < process_pages; r++) { cdf[r] /= sum; rank_page[r] = r; }
+        for (int i = process_pages - 1; i > 0; i--) swap(rank_page[i], rank_page[rand() % (i + 1)]);
+    }
+    long next_vpn() override {
+        int r = upper_bound(cdf.begin(), cdf.end() - 1, rand_unit()) - cdf.begin();
+        return page_to_vpn(rank_page[r]);
+    }
+};
+
+class SequentialGenerator : public AccessGenerator {
+    int run, cur = 0, left = 0;
+public:
+    SequentialGenerator(int run_len) : run(max(1, run_len)) {}
+    long next_vpn() override {
+        if (left-- <= 0) { cur = rand() % process_pages; left = run - 1; }
+        int page = cur;
+        cur = (cur + 1) % process_pages;
+        return page_to_vpn(page);
+    }
+};
+
+class LoopGenerator : public AccessGenerator {
+    int len, cur = 0;
+public:
+    LoopGenerator(int loop_len) : len(min(process_pages, loop_len > 0 ? loop_len : process_pages)) {}
+    long next_vpn() override {
+        int page = cur;
+        cur = (cur + 1) % len;
+        return page_to_vpn(page);
+    }
+};
+
+// 주소 Trace 파일 (fork 전에 한 번 mmap하고 자식들이 읽기 전용으로 공유)
+// 형식: valgrind --tool=lackey --trace-mem=yes 출력 (" L 04222cac,8", "I  0400d7d4,3")
+//       또는 줄마다 16진수 주소 하나 (perf script -F addr 등, "0x" 접두어 허용)
+// 숫자로 시작하지 않는 줄("==123==" 배너 등)은 건너뜀
+struct TraceFile {
+    const char* data = nullptr;
+    size_t size = 0;
+
+    bool open(const string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) { perror(path.c_str()); return false; }
+        struct stat st;
+        if (fstat(fd, &st) < 0 || st.st_size == 0) {
+            fprintf(stderr, "%s: empty trace\n", path.c_str());
+            close(fd);
+            return false;
+        }
+        size = st.st_size;
+        void* p = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) { perror("mmap"); return false; }
+        madvise(p, size, MADV_SEQUENTIAL); // 앞에서부터 한 번 훑으므로 커널이 미리 읽고 지나간 페이지는 버리도록
+        data = (const char*)p;
+        return true;
+    }
+};
+
+TraceFile trace_file;
+
+// 각 프로세스는 파일의 서로 다른 위치(전체를 프로세스 수로 나눈 지점)에서 시작해 끝에 닿으면 처음으로 돌아감
+class TraceGenerator : public AccessGenerator {
+    const char* data;
+    size_t size, pos;
+    long vpn_mask = (1L << VPN_BITS) - 1;
+    int op = 0; // 직전 줄의 lackey 접근 종류 (주소만 있는 줄이면 0)
+
+    static int hex_digit(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    // pos부터 한 줄을 읽어 주소를 돌려줌 (주소가 없는 줄이면 false)
+    bool parse_line(unsigned long* addr) {
+        const char* p = data + pos;
+        const char* end = data + size;
+        const char* eol = (const char*)memchr(p, '\n', end - p);
+        if (!eol) eol = end;
+        pos = (eol == end) ? 0 : eol + 1 - data;
+
+        while (p < eol && *p == ' ') p++;
+        op = 0;
+        if (p < eol && (*p == 'I' || *p == 'L' || *p == 'S' || *p == 'M')) { // lackey 접근 종류
+            op = *p++;
+            while (p < eol && *p == ' ') p++;
+        }
+        if (eol - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) p += 2;
+        if (p >= eol || hex_digit(*p) < 0) return false;
+        unsigned long v = 0;
+        for (int d; p < eol && (d = hex_digit(*p)) >= 0; p++) v = (v << 4) | d;
+        *addr = v;
+        return true;
+    }
 
-    last_victim_frame = -1; // Reset effect
+public:
+    TraceGenerator(const TraceFile& f, int logic_pid) : data(f.data), size(f.size) {
+        pos = size / process_count * logic_pid;
+        if (pos > 0) { // 줄 중간이면 다음 줄부터
+            const char* nl = (const char*)memchr(data + pos, '\n', size - pos);
+            pos = nl && nl + 1 < data + size ? nl + 1 - data : 0;
+        }
+    }
+    long next_vpn() override {
+        unsigned long addr;
+        for (size_t lines = 0;; lines++) {
+            if (parse_line(&addr)) return (long)(addr >> PAGE_SHIFT) & vpn_mask;
+            if (lines > size) { fprintf(stderr, "trace has no addresses\n"); exit(1); }
+        }
+    }
+    bool last_write() override { return op ? (op == 'S' || op == 'M') : AccessGenerator::last_write(); }
+};
+
+// 공유 영역 (--shared): 모든 프로세스가 같은 VPN에 매핑하는 공유 라이브러리/공유 메모리 페이지
+// 접근의 shared_pct%를 이 영역으로 보내고, 나머지는 원래 패턴을 따름 (쓰기도 복사 없이 같은 프레임에 반영)
+#define SHARED_BASE_VPN (0x7fe000000000L >> PAGE_SHIFT)
+#define MAX_SHARED_PAGES (1 << 20)
+
+class SharedRegionGenerator : public AccessGenerator {
+    AccessGenerator* inner;
+    bool shared = false;
+public:
+    explicit SharedRegionGenerator(AccessGenerator* g) : inner(g) {}
+    ~SharedRegionGenerator() { delete inner; }
+    long next_vpn() override {
+        shared = rand() % 100 < workload.shared_pct;
+        return shared ? SHARED_BASE_VPN + rand() % workload.shared_pages : inner->next_vpn();
+    }
+    bool last_write() override { return shared ? AccessGenerator::last_write() : inner->last_write(); }
+};
+
+// 공유 영역 페이지 번호 (영역 밖이면 -1)
+inline int shared_index(long vpn) {
+    long i = vpn - SHARED_BASE_VPN;
+    return (i >= 0 && i < workload.shared_pages) ? (int)i : -1;
+}
+
+AccessGenerator* make_generator(const WorkloadConfig& c, int logic_pid) {
+    AccessGenerator* gen;
+    switch (c.type) {
+        case WL_WORKING_SET: gen = new WorkingSetGenerator(c); break;
+        case WL_ZIPF:        gen = new ZipfGenerator(c.zipf_s); break;
+        case WL_SEQUENTIAL:  gen = new SequentialGenerator(c.scan_run); break;
+        case WL_LOOP:        gen = new LoopGenerator(c.loop_len); break;
+        case WL_TRACE:       gen = new TraceGenerator(trace_file, logic_pid); break;
+        default:             gen = new UniformGenerator(); break;
+    }
+    return c.shared_pages > 0 ? new SharedRegionGenerator(gen) : gen;
+}
+
+bool parse_workload(const char* name, WorkloadType* type) {
+    static const struct { const char* name; WorkloadType type; } table[] = {
+        {"uniform", WL_UNIFORM}, {"ws", WL_WORKING_SET}, {"zipf", WL_ZIPF},
+        {"seq", WL_SEQUENTIAL}, {"loop", WL_LOOP}, {"trace", WL_TRACE},
+    };
+    for (const auto& t : table) {
+        if (strcmp(name, t.name) == 0) { *type = t.type; return true; }
+    }
+    return false;
 }
 
 // 5. User Process
@@ -159,17 +1697,41 @@ void run_child(int logic_pid) {
     srand(time(NULL) + logic_pid * 100);
     int cpu_burst = rand() % 20 + 5; 
     int io_burst = rand() % 10 + 2;  
+    AccessGenerator* gen = make_generator(workload, logic_pid);
+
+    if (transport == TRANSPORT_SHM) {
+        AccessRing* ring = access_ring(logic_pid);
+        for (uint32_t seq = 0;; seq++) {
+            // 링이 가득 차면 커널이 배치 하나를 처리할 때까지 대기
+            uint32_t t;
+            while (seq - (t = ring->tail.load(memory_order_acquire)) >= RING_BATCHES)
+                wait_change(ring->tail, ring->child_waiting, t);
+            AccessRec* recs = ring_batch(ring, seq);
+            for (int i = 0; i < batch_size; i++) {
+                recs[i].vpn = gen->next_vpn();
+                recs[i].write = gen->last_write();
+            }
+            ring->cpu_burst[seq % RING_BATCHES] = cpu_burst;
+            publish(ring->head, ring->kernel_waiting);
+
+            cpu_burst--;
+            if (cpu_burst <= 0) cpu_burst = rand() % 20 + 5;
+        }
+    }
 
     while (true) {
         if (msgrcv(q1_id, &msg, sizeof(MsgBuf) - sizeof(long), logic_pid + 1, 0) == -1) exit(1);
 
-        for (int i = 0; i < ACCESS_PER_TICK; i++) msg.access_pages[i] = rand() % 200; 
+        for (int i = 0; i < batch_size; i++) {
+            msg.accesses[i].vpn = gen->next_vpn();
+            msg.accesses[i].write = gen->last_write();
+        }
         msg.cpu_burst = cpu_burst;
         msg.io_burst = io_burst;
         msg.pid = logic_pid;
         msg.mtype = 999; 
 
-        if (msgsnd(q2_id, &msg, sizeof(MsgBuf) - sizeof(long), 0) == -1) exit(1);
+        if (msgsnd(q2_id, &msg, msg_size(batch_size), 0) == -1) exit(1);
 
         cpu_burst--;
         if (cpu_burst <= 0) cpu_burst = rand() % 20 + 5;
@@ -180,30 +1742,206 @@ void run_child(int logic_pid) {
 void run_kernel() {
     deque<PCB*> run_queue;
     deque<PCB*> wait_queue;
-    PCB* pcb_table[PROCESS_COUNT];
+    vector<PCB*> pcb_table(process_count);
 
     // Initialization
-    for (int i = 0; i < TOTAL_FRAMES; i++) {
-        free_frame_list.push_back(i);
-        frame_table[i] = {-1, -1}; // No owner
-    }
+    free_frame_list.init(total_frames);
+    frame_table.assign(total_frames, {-1, -1}); // No owner
 
-    sleep(1); 
+    if (!headless) dashboard.start(refresh_ms);
 
-    for (int i = 0; i < PROCESS_COUNT; i++) {
+    for (int i = 0; i < process_count; i++) {
         PCB* pcb = new PCB();
         pcb->logical_pid = i;
         pcb->page_fault_count = 0;
         pcb->swap_count = 0;
-        pcb->page_table.resize(200, {false, false, -1}); 
-        run_queue.push_back(pcb);
+        pcb->resident_frames = 0;
+        pcb->quota = max(1, total_frames / process_count);
+        if (fork_tick < 0 || i == 0) run_queue.push_back(pcb); // --fork: 나머지는 fork 시점에 생성
         pcb_table[i] = pcb;
     }
+    shared_frame.assign(workload.shared_pages, -1);
+    vector<PCB*> active_order(pcb_table); // 활성화된 순서 (Load Control은 가장 나중에 활성화된 프로세스부터 중단)
+    vector<PCB*> suspended_stack;
+    bool track_ws = alloc_mode == ALLOC_WS || (load_control && alloc_mode != ALLOC_PFF);
+    int windows = fault_window > 0 ? (sim_ticks + fault_window - 1) / fault_window : 0;
+    win_access.assign(windows, vector<long>(process_count, 0));
+    win_faults.assign(windows, vector<long>(process_count, 0));
+    win_suspended.assign(windows, 0);
 
     int tick = 0;
     MsgBuf msg;
+    PCB* last_proc = nullptr;
+    double now_us = 0;
+
+    // 접근된 프레임 상태 갱신 (Read-ahead 적중 집계, 쓰기면 Dirty)
+    auto touch_frame = [&](int frame, bool write) {
+        FrameInfo& fi = frame_table[frame];
+        if (fi.prefetched) { prefetch_hits++; fi.prefetched = false; }
+        if (write) {
+            fi.dirty = true;
+            if (swap_dev.enabled()) swap_dev.touch(frame);
+        }
+    };
+
+    // 프레임에 있던 페이지를 주인의 Page Table에서 내림 (Huge Page의 일부라면 4KB 단위로 분할한 뒤 해당 페이지만 해제)
+    // 공유 프레임이면 매핑한 모든 프로세스의 PTE와 TLB 항목을 함께 내림
+    // Swap 장치가 있으면 Dirty 페이지만 Swap 파일에 기록함 (Swap은 공유 프레임이 없을 때만 사용)
+    auto unmap_frame = [&](int frame) {
+        FrameInfo& info = frame_table[frame];
+        if (info.pid == -1) return;
+        for (int sharer : info.sharers) {
+            PCB* p = pcb_table[sharer];
+            p->page_table.evict(info.vpn);
+            p->swap_count++;
+            p->resident_frames--;
+            if (tlb.enabled()) tlb.invalidate(sharer + 1, info.vpn);
+        }
+        info.sharers.clear();
+        int idx = shared_index(info.vpn);
+        if (idx >= 0) shared_frame[idx] = -1;
+        PCB* owner = pcb_table[info.pid];
+        owner->page_table.evict(info.vpn);
+        owner->swap_count++;
+        owner->resident_frames--;
+        if (tlb.enabled()) tlb.invalidate(info.pid + 1, info.vpn);
+        if (swap_dev.enabled()) {
+            PageEntry& e = owner->page_table.pte(info.vpn);
+            if (info.dirty) e.swap_slot = swap_dev.write_back(frame, e.swap_slot, now_us);
+            else if (e.swap_slot) swap_dev.clean_skips++;
+            else swap_dev.zero_drops++;
+        }
+    };
+
+    // 정책이 고른 Victim 프레임을 회수 (local이면 pid 자신의 프레임 중에서 고름)
+    auto reclaim_frame = [&](int pid, long vpn, bool local, int* victim_pid) {
+        total_swap_outs++;
+        int frame = local ? replacer->victim_local(pid) : replacer->victim(page_key(pid, vpn));
+        *victim_pid = frame_table[frame].pid;
+        unmap_frame(frame);
+        last_victim_frame = frame; // For Visuals
+        return frame;
+    };
+
+    // 공유 프레임에서 pid의 매핑만 뗌 (대표 매핑이면 남은 매핑 하나가 대표가 됨)
+    auto drop_sharer = [&](int frame, int pid) {
+        FrameInfo& fi = frame_table[frame];
+        if (fi.pid == pid) { fi.pid = fi.sharers.back(); fi.sharers.pop_back(); }
+        else fi.sharers.erase(find(fi.sharers.begin(), fi.sharers.end(), pid));
+    };
+
+    // fork로 물려받아 아직 여러 프로세스가 함께 쓰는 페이지 (쓰기 금지, 쓰면 복사)
+    // 공유 영역은 쓰기도 같은 프레임에 하고, 매핑이 하나만 남은 페이지는 복사 없이 그대로 씀
+    auto is_cow = [&](int frame, long vpn) { return shared_index(vpn) < 0 && !frame_table[frame].sharers.empty(); };
+
+    // fork(): P0의 주소 공간을 나머지 프로세스에 PTE만 복사 (프레임은 참조 수만 늘림)
+    // P0의 TLB 항목은 쓰기 금지로 바뀌었으므로 내림
+    auto fork_children = [&]() {
+        for (int f = 0; f < total_frames; f++) {
+            FrameInfo& fi = frame_table[f];
+            if (fi.pid != 0) continue; // fork 전에는 P0만 실행됨
+            bool shared = shared_index(fi.vpn) >= 0;
+            if (!shared && tlb.enabled()) tlb.invalidate(1, fi.vpn);
+            for (int c = 1; c < process_count; c++) {
+                pcb_table[c]->page_table.pte(fi.vpn) = {true, false, f, 0};
+                pcb_table[c]->resident_frames++;
+                fi.sharers.push_back(c);
+            }
+            if (!shared) cow_inherited++;
+        }
+        for (int c = 1; c < process_count; c++) run_queue.push_back(pcb_table[c]);
+    };
+
+    // 프레임을 비워 빈 프레임 목록으로 돌려줌 (in_policy: 아직 정책 관리 목록에 있음)
+    auto release_frame = [&](int frame, bool in_policy) {
+        if (in_policy) replacer->remove(frame);
+        unmap_frame(frame);
+        frame_table[frame] = {-1, -1};
+        free_frame_list.push(frame);
+    };
+
+    // 상주 프레임을 target 개로 줄임 (어느 프레임을 내놓을지는 정책이 Local 기준으로 고름)
+    auto shrink_resident = [&](PCB* p, int target) {
+        while (p->resident_frames > target) release_frame(replacer->victim_local(p->logical_pid), false);
+    };
+
+    // Local Replacement 기준: 이미 할당량만큼 가지고 있으면 자기 프레임을 교체 (ws는 Window가 상주 집합을 정하므로 제한 없음)
+    auto over_quota = [&](PCB* p) {
+        return (alloc_mode == ALLOC_LOCAL || alloc_mode == ALLOC_PFF) && p->resident_frames >= p->quota;
+    };
+
+    // Working Set Window를 한 칸 밀고, Window에서 빠진 페이지는 (ws 모드면) 바로 반납
+    auto ws_reference = [&](PCB* p, long vpn) {
+        if (p->ws_count[vpn]++ == 0) p->wss++;
+        p->ws_refs.push_back(vpn);
+        if ((int)p->ws_refs.size() <= ws_window) return;
+        long old = p->ws_refs.front();
+        p->ws_refs.pop_front();
+        auto it = p->ws_count.find(old);
+        if (--it->second > 0) return;
+        p->ws_count.erase(it);
+        p->wss--;
+        if (alloc_mode != ALLOC_WS) return;
+        int levels;
+        int frame = p->page_table.translate(old, &levels);
+        if (frame >= 0) { release_frame(frame, true); ws_releases++; }
+    };
+
+    // PFF: 측정 구간이 차면 Fault 비율에 따라 할당량 조정
+    auto pff_update = [&](PCB* p, int accesses, int faults) {
+        p->pff_access += accesses;
+        p->pff_faults += faults;
+        if (p->pff_access < pff_interval) return;
+        long rate = p->pff_faults * 100 / p->pff_access;
+        int step = max(1, p->quota / 8);
+        if (rate > pff_high && p->quota < total_frames) {
+            p->quota = min(total_frames, p->quota + step);
+            pff_grows++;
+        } else if (rate < pff_low && p->quota > 1) {
+            p->quota = max(1, p->quota - step);
+            shrink_resident(p, p->quota);
+            pff_shrinks++;
+        }
+        p->pff_access = p->pff_faults = 0;
+    };
+
+    // Load Control: 활성 프로세스의 요구량(Working Set 크기 또는 PFF 할당량) 합이 프레임 수를 넘으면
+    // 가장 나중에 활성화된 프로세스를 중단해 프레임을 모두 회수하고, 여유가 생기면 마지막으로 중단한 프로세스부터 재개
+    auto demand_of = [&](PCB* p) { return alloc_mode == ALLOC_PFF ? p->quota : max(1, p->wss); };
+    auto balance_load = [&]() {
+        long demand = 0;
+        for (PCB* p : active_order) demand += demand_of(p);
+        bool changed = false;
+        while (demand > total_frames && active_order.size() > 1) {
+            // Swap In을 기다리는 프로세스는 건너뜀
+            auto it = find_if(active_order.rbegin(), active_order.rend(), [&](PCB* p) {
+                return find(run_queue.begin(), run_queue.end(), p) != run_queue.end();
+            });
+            if (it == active_order.rend()) break;
+            PCB* p = *it;
+            active_order.erase(next(it).base());
+            run_queue.erase(find(run_queue.begin(), run_queue.end(), p));
+            p->suspended = true;
+            shrink_resident(p, 0);
+            suspended_stack.push_back(p);
+            demand -= demand_of(p);
+            suspensions++;
+            changed = true;
+        }
+        if (!changed && !suspended_stack.empty() && demand + demand_of(suspended_stack.back()) <= total_frames) {
+            PCB* p = suspended_stack.back();
+            suspended_stack.pop_back();
+            p->suspended = false;
+            active_order.push_back(p);
+            run_queue.push_back(p);
+            resumes++;
+        }
+    };
+
+    while (tick < sim_ticks) {
+        now_us = (double)tick * TICK_US;
+        if (tick == fork_tick) fork_children();
 
-    while (tick < SIMULATION_TICKS) {
         // Handle IO
         int wq_size = wait_queue.size();
         while(wq_size--) {
@@ -213,24 +1951,87 @@ void run_kernel() {
             else wait_queue.push_back(proc);
         }
 
+        if (load_control) balance_load();
+        int window = fault_window > 0 ? tick / fault_window : -1;
+        if (window >= 0) win_suspended[window] = max(win_suspended[window], (int)suspended_stack.size());
+
+        if (run_queue.empty()) idle_ticks++;
         if (!run_queue.empty()) {
             PCB* current_proc = run_queue.front(); run_queue.pop_front();
+            int asid = current_proc->logical_pid + 1;
+            if (current_proc != last_proc) {
+                context_switches++;
+                if (tlb.enabled()) tlb.on_switch();
+                last_proc = current_proc;
+            }
 
-            // Handshake
-            msg.mtype = current_proc->logical_pid + 1;
-            msgsnd(q1_id, &msg, sizeof(MsgBuf) - sizeof(long), 0);
-            msgrcv(q2_id, &msg, sizeof(MsgBuf) - sizeof(long), 999, 0);
+            // Handshake (shm은 자식이 미리 채워 둔 배치를 링에서 바로 읽음)
+            const AccessRec* recs;
+            AccessRing* ring = nullptr;
+            uint32_t seq = 0;
+            if (transport == TRANSPORT_SHM) {
+                ring = access_ring(current_proc->logical_pid);
+                seq = ring->tail.load(memory_order_relaxed);
+                wait_change(ring->head, ring->kernel_waiting, seq);
+                recs = ring_batch(ring, seq);
+                msg.cpu_burst = ring->cpu_burst[seq % RING_BATCHES];
+            } else {
+                msg.mtype = current_proc->logical_pid + 1;
+                msgsnd(q1_id, &msg, msg_size(0), 0);
+                msgrcv(q2_id, &msg, sizeof(MsgBuf) - sizeof(long), 999, 0);
+                recs = msg.accesses;
+            }
 
-            for (int i = 0; i < ACCESS_PER_TICK; i++) {
+            bool blocked = false; // Swap In을 기다리면 이번 Tick의 나머지 접근은 하지 않음
+            int accesses = 0, faults_before = current_proc->page_fault_count;
+            for (int i = 0; i < batch_size && !blocked; i++) {
                 total_access++;
-                int page_idx = msg.access_pages[i];
-                PageEntry& entry = current_proc->page_table[page_idx];
+                accesses++;
+                long vpn = recs[i].vpn;
+                bool write = recs[i].write;
+                int pid = current_proc->logical_pid;
+                RadixPageTable& pt = current_proc->page_table;
+                if (compare_policies) access_trace.push_back(page_key(pid, vpn));
+                if (mrc.enabled()) mrc.access(pid, page_key(pid, vpn));
+                if (track_ws) ws_reference(current_proc, vpn);
 
-                if (entry.valid) {
+                // TLB 조회: 적중하면 Page Table을 보지 않고 변환 완료 (COW 페이지에 쓰면 쓰기 금지 Fault로 Page Table 경로 처리)
+                int tlb_frame;
+                if (tlb.enabled() && tlb.lookup(asid, vpn, &tlb_frame) && !(write && is_cow(tlb_frame, vpn))) {
+                    replacer->on_hit(tlb_frame);
+                    touch_frame(tlb_frame, write);
+                    trace_event(REC_TLB_HIT, tick, pid, vpn, tlb_frame);
+                    continue;
+                }
+                total_page_walks++;
+                int levels;
+                int mapped_frame = pt.translate(vpn, &levels);
+                walk_levels += levels;
+
+                if (mapped_frame >= 0 && write && is_cow(mapped_frame, vpn)) {
+                    // Copy-on-Write: 새 프레임에 복사하고 자신의 매핑만 옮김
+                    total_page_faults++;
+                    current_proc->page_fault_count++;
+                    int victim_pid = -1;
+                    int copy = !free_frame_list.empty() ? free_frame_list.pop() : reclaim_frame(pid, vpn, false, &victim_pid);
+                    if (pt.translate(vpn, &levels) == mapped_frame) { // 원본이 Victim으로 회수됐으면 이미 내려감
+                        drop_sharer(mapped_frame, pid);
+                        current_proc->resident_frames--;
+                        cow_copies++;
+                    }
+                    pt.pte(vpn) = {true, false, copy, 0};
+                    current_proc->resident_frames++;
+                    frame_table[copy] = {pid, vpn};
+                    replacer->on_load(copy, page_key(pid, vpn));
+                    touch_frame(copy, true);
+                    if (tlb.enabled()) { tlb.invalidate(asid, vpn); tlb.insert(asid, vpn, copy); }
+                    trace_event(REC_FAULT_COW, tick, pid, vpn, copy);
+                } else if (mapped_frame >= 0) {
+                    replacer->on_hit(mapped_frame);
+                    touch_frame(mapped_frame, write);
                     // Hit
-                    char buf[100];
-                    snprintf(buf, sizeof(buf), "Access VA:%d -> PA:%d (Hit)", page_idx, entry.frame_number);
-                    log_event(tick, current_proc->logical_pid, buf);
+                    trace_event(REC_HIT, tick, pid, vpn, mapped_frame);
+                    if (tlb.enabled()) tlb.insert(asid, vpn, mapped_frame);
                 } else {
                     // Page Fault
                     total_page_faults++;
@@ -240,92 +2041,1044 @@ void run_kernel() {
                     bool replacement_occurred = false;
                     int victim_pid = -1;
 
-                    // 1. Try to get free frame
-                    if (!free_frame_list.empty()) {
-                        allocated_frame = free_frame_list.front();
-                        free_frame_list.pop_front();
+                    // 공유 영역: 다른 프로세스가 이미 올려 둔 페이지면 새 프레임 없이 같은 프레임을 매핑
+                    int shared_idx = shared_index(vpn);
+                    if (shared_idx >= 0 && shared_frame[shared_idx] >= 0) {
+                        int f = shared_frame[shared_idx];
+                        pt.pte(vpn) = {true, false, f, 0};
+                        frame_table[f].sharers.push_back(pid);
+                        current_proc->resident_frames++;
+                        shared_maps++;
+                        replacer->on_hit(f);
+                        touch_frame(f, write);
+                        if (tlb.enabled()) tlb.insert(asid, vpn, f);
+                        trace_event(REC_FAULT_SHARED, tick, pid, vpn, f);
+                        continue;
+                    }
+
+                    // 0. Huge Page: 2MB 영역이 비어 있고 연속 512 프레임이 있으면 영역 전체를 한 번에 매핑
+                    int huge_base = -1;
+                    if (huge_pages && alloc_mode == ALLOC_GLOBAL && pt.can_map_huge(vpn)) huge_base = free_frame_list.pop_block();
+                    if (huge_base >= 0) {
+                        long first_vpn = vpn & ~(long)(HUGE_PAGES - 1);
+                        pt.map_huge(first_vpn, huge_base);
+                        for (int k = 0; k < HUGE_PAGES; k++) {
+                            frame_table[huge_base + k] = {pid, first_vpn + k};
+                            replacer->on_load(huge_base + k, page_key(pid, first_vpn + k));
+                            if (swap_dev.enabled()) swap_dev.zero_fill(huge_base + k, pid, first_vpn + k);
+                        }
+                        current_proc->resident_frames += HUGE_PAGES;
+                        allocated_frame = huge_base + (int)(vpn - first_vpn);
+                        touch_frame(allocated_frame, write);
+                        if (tlb.enabled()) tlb.insert(asid, vpn, allocated_frame);
+                        trace_event(REC_FAULT_HUGE, tick, pid, vpn, allocated_frame);
+                        continue;
+                    }
+
+                    // 1. Local Replacement: 할당량을 다 쓴 프로세스는 자기 프레임을 교체
+                    if (over_quota(current_proc)) {
+                        replacement_occurred = true;
+                        allocated_frame = reclaim_frame(pid, vpn, true, &victim_pid);
+                    }
+                    // 2. Try to get free frame
+                    else if (!free_frame_list.empty()) {
+                        allocated_frame = free_frame_list.pop();
                     } 
-                    // 2. FIFO Replacement (Senior's Logic)
+                    // 3. Replacement (정책이 고른 Victim 프레임을 회수)
                     else {
                         replacement_occurred = true;
-                        total_swap_outs++;
-                        
-                        // FIFO: Pop from front (Oldest)
-                        allocated_frame = active_frames_queue.front();
-                        active_frames_queue.pop_front();
-
-                        // Invalidate Old Owner
-                        FrameInfo& info = frame_table[allocated_frame];
-                        victim_pid = info.pid;
-                        if (victim_pid != -1) {
-                            pcb_table[victim_pid]->page_table[info.page_idx].valid = false;
-                            pcb_table[victim_pid]->page_table[info.page_idx].is_swapped = true;
-                            pcb_table[victim_pid]->swap_count++;
-                        }
-                        last_victim_frame = allocated_frame; // For Visuals
+                        allocated_frame = reclaim_frame(pid, vpn, false, &victim_pid);
                     }
 
-                    // 3. Update Tables
+                    // 4. Update Tables
+                    PageEntry& entry = pt.pte(vpn);
+                    bool major = swap_dev.enabled() && entry.is_swapped && entry.swap_slot > 0;
                     entry.frame_number = allocated_frame;
                     entry.valid = true;
                     entry.is_swapped = false;
+                    current_proc->resident_frames++;
+                    frame_table[allocated_frame] = {pid, vpn}; // Update Reverse Map
+                    if (shared_idx >= 0) shared_frame[shared_idx] = allocated_frame;
+                    if (tlb.enabled()) tlb.insert(asid, vpn, allocated_frame);
+
+                    if (major) {
+                        // Swap In: 뒤쪽으로 이어진 Swap Out 페이지를 같은 요청으로 함께 읽음 (Read-ahead)
+                        // 요청 페이지는 Read-ahead가 끝난 뒤 정책에 넣어 Read-ahead용 회수 대상이 되지 않게 함
+                        swap_dev.read_page(allocated_frame, entry.swap_slot, pid, vpn);
+                        int pages = 1;
+                        for (int k = 1; k <= prefetch_pages; k++) {
+                            PageEntry* pe = pt.find_pte(vpn + k);
+                            if (!pe || pe->valid || !pe->is_swapped || pe->swap_slot == 0) continue;
+                            if (over_quota(current_proc)) break; // Read-ahead는 할당량을 넘기지 않음
+                            int slot = pe->swap_slot; // 회수 과정에서 Page Table이 늘어나도 값은 먼저 보관
+                            int pf, pv = -1;
+                            if (!free_frame_list.empty()) pf = free_frame_list.pop();
+                            else pf = reclaim_frame(pid, vpn + k, false, &pv);
+                            pe = &pt.pte(vpn + k);
+                            swap_dev.read_page(pf, slot, pid, vpn + k);
+                            *pe = {true, false, pf, slot};
+                            current_proc->resident_frames++;
+                            frame_table[pf] = {pid, vpn + k, false, true};
+                            replacer->on_load(pf, page_key(pid, vpn + k));
+                            prefetch_loads++;
+                            pages++;
+                        }
+                        double done = swap_dev.read_done(pages, now_us);
+                        swap_dev.wait_us += done - now_us;
+                        major_faults++;
+
+                        // 읽기가 끝날 때까지 wait_queue에서 대기
+                        current_proc->io_remaining = max(1, (int)ceil((done - now_us) / TICK_US));
+                        blocked = true;
+                    } else if (swap_dev.enabled()) {
+                        swap_dev.zero_fill(allocated_frame, pid, vpn);
+                    }
                     
-                    // Add to FIFO Queue (Newest is at back)
-                    active_frames_queue.push_back(allocated_frame);
-                    
-                    // Update Reverse Map
-                    frame_table[allocated_frame] = {current_proc->logical_pid, page_idx};
+                    // 정책에 적재 사실 통보 (FIFO라면 Queue 맨 뒤에 추가)
+                    replacer->on_load(allocated_frame, page_key(pid, vpn));
+                    touch_frame(allocated_frame, write);
 
-                    // 4. Logging & Effects
-                    if (replacement_occurred) {
+                    // 5. Logging & Effects (대시보드 문구는 화면이 있을 때만 만듦)
+                    if (replacement_occurred) trace_event(REC_FAULT_SWAP, tick, pid, vpn, allocated_frame, victim_pid);
+                    else trace_event(REC_FAULT_NEW, tick, pid, vpn, allocated_frame);
+                    if (replacement_occurred && !headless) {
                         string quote = BATTLE_QUOTES[rand() % BATTLE_QUOTES.size()];
-                        string vic_emoji = (victim_pid != -1) ? P_EMOJIS[victim_pid] : "👻";
+                        string vic_emoji = (victim_pid != -1) ? P_EMOJIS[victim_pid % 10] : "👻";
                         char lbuf[256];
-                        snprintf(lbuf, sizeof(lbuf), "⚔️ [FIFO SWAP] %s P%d replaces %s P%d: \"%s\"", 
-                            P_EMOJIS[current_proc->logical_pid].c_str(), current_proc->logical_pid,
+                        string tag = replacer->name();
+                        transform(tag.begin(), tag.end(), tag.begin(), ::toupper);
+                        snprintf(lbuf, sizeof(lbuf), "⚔️ [%s SWAP] %s P%d replaces %s P%d: \"%s\"", tag.c_str(),
+                            P_EMOJIS[pid % 10].c_str(), pid,
                             vic_emoji.c_str(), victim_pid, quote.c_str());
                         last_battle_log = string(lbuf);
-                        log_event(tick, current_proc->logical_pid, "Page Fault & Swap Out P" + to_string(victim_pid));
-                    } else {
-                        log_event(tick, current_proc->logical_pid, "Page Fault & New Alloc");
                     }
                 }
             }
             
+            if (ring) publish(ring->tail, ring->child_waiting); // Swap In으로 중단됐어도 배치 전체를 소비
+            int faults = current_proc->page_fault_count - faults_before;
+            if (window >= 0) {
+                win_access[window][current_proc->logical_pid] += accesses;
+                win_faults[window][current_proc->logical_pid] += faults;
+            }
+            if (alloc_mode == ALLOC_PFF) pff_update(current_proc, accesses, faults);
+
             current_proc->cpu_burst = msg.cpu_burst;
-            run_queue.push_back(current_proc); 
+            if (blocked) wait_queue.push_back(current_proc);
+            else run_queue.push_back(current_proc); 
         }
         
-        if(tick % 5 == 0) print_system_status(tick, pcb_table);
+        flush_trace();
+        if (!headless) dashboard.publish(tick, pcb_table);
         tick++;
-        usleep(100000); // 0.1s delay
+        if (tick_delay_ms > 0) usleep(tick_delay_ms * 1000);
+    }
+    dashboard.stop();
+
+    share_stats = {};
+    for (PCB* pcb : pcb_table) share_stats.rss_sum += pcb->resident_frames;
+    for (const FrameInfo& fi : frame_table) {
+        if (fi.pid < 0) continue;
+        share_stats.frames_used++;
+        if (shared_index(fi.vpn) >= 0) {
+            share_stats.shared_resident++;
+            share_stats.shared_mappings += 1 + fi.sharers.size();
+        } else if (!fi.sharers.empty()) {
+            share_stats.cow_shared++;
+        }
+    }
+    for (PCB* pcb : pcb_table) delete pcb;
+}
+
+// 6-0. Page Table Footprint
+// 희소한 48비트 주소 공간에서 필요한 테이블만 만든 결과를 평면(1단계) 테이블과 비교함
+void print_page_table_footprint() {
+    static const char* names[PT_LEVELS] = {"PGD", "PUD", "PMD", "PTE"};
+    long tables = 0;
+    for (int l = 0; l < PT_LEVELS; l++) tables += pt_stats.tables[l];
+    double sim_kb = tables * (double)PT_ENTRIES * PTE_SIZE / 1024;
+    double flat_gb = (double)process_count * (1L << VPN_BITS) * PTE_SIZE / (1L << 30);
+
+    printf("Page Tables: ");
+    for (int l = 0; l < PT_LEVELS; l++) printf("%s %ld%s", names[l], pt_stats.tables[l], l + 1 < PT_LEVELS ? ", " : "");
+    printf(" | Footprint: %.1f KB (%.2f KB/process, host %.1f KB) | Flat 48-bit: %.0f GB\n", sim_kb,
+           sim_kb / process_count, pt_stats.host_bytes / 1024.0, flat_gb);
+    printf("Huge Pages: %ld mapped, %ld split | Avg Walk Depth: %.2f levels\n", pt_stats.huge_maps, pt_stats.huge_splits,
+           total_page_walks ? (double)walk_levels / total_page_walks : 0.0);
+}
+
+// 6-0-1. Swap & Effective Access Time
+// EAT = 메모리 접근 시간 + (Minor Fault 수 x 0으로 채우는 비용 + Swap In 대기 시간 합) / 접근 수
+void print_swap_stats() {
+    long minor = total_page_faults - major_faults;
+    double extra_ns = (minor * (double)ZERO_FILL_US + swap_dev.wait_us) * 1000.0;
+    double eat = mem_latency_ns + (total_access ? extra_ns / total_access : 0.0);
+    printf("Swap: Major Faults %ld (%.2f%%), Minor %ld | Avg Swap In Wait %.2f ms | Reads %ld (%ld pages) | Writes %ld | Clean Skips %ld | Zero Drops %ld | Corrupt %ld | Swap File %.1f KB\n",
+           major_faults, total_access ? major_faults * 100.0 / total_access : 0.0, minor,
+           major_faults ? swap_dev.wait_us / major_faults / 1000.0 : 0.0, swap_dev.reads, swap_dev.read_pages,
+           swap_dev.writes, swap_dev.clean_skips, swap_dev.zero_drops, swap_dev.corrupt,
+           swap_dev.slots_used() * PAGE_SIZE / 1024.0);
+    if (prefetch_pages > 0)
+        printf("Read-ahead: %d pages | Loaded %ld | Used %ld (%.1f%%)\n", prefetch_pages, prefetch_loads, prefetch_hits,
+               prefetch_loads ? prefetch_hits * 100.0 / prefetch_loads : 0.0);
+    printf("EAT: %.1f ns (memory %d ns, %.1fx) | CPU Utilization: %.1f%% (%ld idle ticks waiting for swap)\n", eat,
+           mem_latency_ns, eat / mem_latency_ns, sim_ticks ? (sim_ticks - idle_ticks) * 100.0 / sim_ticks : 0.0,
+           idle_ticks);
+}
+
+// 6-0-2. Resident Set Management & Fault Rate by Window
+// 구간(fault_window Tick)마다 프로세스별 Fault 비율을 나열해 Thrashing이 생기거나 막히는 과정을 보여줌
+const char* alloc_name(AllocMode m) {
+    switch (m) {
+        case ALLOC_LOCAL: return "local";
+        case ALLOC_WS:    return "ws";
+        case ALLOC_PFF:   return "pff";
+        default:          return "global";
+    }
+}
+
+void print_fault_windows() {
+    printf("Allocation: %s", alloc_name(alloc_mode));
+    if (alloc_mode == ALLOC_WS) printf(" (window %d) | WS Releases: %ld", ws_window, ws_releases);
+    if (alloc_mode == ALLOC_PFF) printf(" (%d%%-%d%% per %d accesses) | Grows: %ld | Shrinks: %ld", pff_low, pff_high, pff_interval, pff_grows, pff_shrinks);
+    if (load_control) printf(" | Load Control: %ld suspensions, %ld resumes", suspensions, resumes);
+    printf("\n");
+    if (win_access.empty()) return;
+
+    int shown = min(process_count, DASHBOARD_PROCS);
+    printf("\n==== Page Fault Rate by Window (%d ticks, %%) ====\n", fault_window);
+    printf("%-13s", "Ticks");
+    for (int i = 0; i < shown; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "P%d", i);
+        printf(" %6s", name);
+    }
+    printf(" %7s %5s\n", "All", "Susp");
+    for (size_t w = 0; w < win_access.size(); w++) {
+        char range[32];
+        snprintf(range, sizeof(range), "%zu-%zu", w * fault_window, min<size_t>((w + 1) * fault_window, sim_ticks) - 1);
+        printf("%-13s", range);
+        long acc = 0, flt = 0;
+        for (int i = 0; i < process_count; i++) { acc += win_access[w][i]; flt += win_faults[w][i]; }
+        for (int i = 0; i < shown; i++) {
+            if (win_access[w][i]) printf(" %6.1f", win_faults[w][i] * 100.0 / win_access[w][i]);
+            else printf(" %6s", "-"); // 이 구간에 실행되지 않음 (중단 또는 Swap In 대기)
+        }
+        if (acc) printf(" %7.1f", flt * 100.0 / acc);
+        else printf(" %7s", "-");
+        printf(" %5d\n", win_suspended[w]);
+    }
+}
+
+// 6-0-3. Miss Ratio Curve
+// 실행 중 접근 순서대로 구한 재사용 거리로 프레임 수별 LRU Fault 수를 추정함 (전체는 모든 프로세스가 프레임을 공유하는 Global LRU,
+// 프로세스별 곡선은 그 프로세스에만 프레임 c개를 줄 때). 접근 순서는 실제 실행과 같으므로 --policy lru면 현재 프레임 수의 값이 실제 Fault 수와 같음
+// PREFIX_mrc.csv: 프레임 수별 전체 추정 Fault 수/Miss Ratio와 프로세스별 Miss Ratio
+// PREFIX_reuse.csv: 재사용 거리별 재접근 수 (cold는 처음 접근)
+bool write_mrc_csv(const string& prefix) {
+    int frames = max(mrc.curve_end(), total_frames);
+    vector<vector<double>> curves;
+    curves.push_back(mrc.miss_curve(mrc.all, frames));
+    for (const ReuseStack& s : mrc.procs) curves.push_back(mrc.miss_curve(s, frames));
+
+    string path = prefix + "_mrc.csv";
+    FILE* fp = fopen(path.c_str(), "w");
+    if (!fp) { perror(path.c_str()); return false; }
+    fprintf(fp, "frames,faults,miss_ratio");
+    for (size_t i = 0; i < mrc.procs.size(); i++) fprintf(fp, ",p%zu", i);
+    fprintf(fp, "\n");
+    for (int c = 1; c <= frames; c++) {
+        fprintf(fp, "%d,%.0f,%.6f", c, curves[0][c] * mrc.total_refs, curves[0][c]);
+        for (size_t i = 1; i < curves.size(); i++) fprintf(fp, ",%.6f", curves[i][c]);
+        fprintf(fp, "\n");
+    }
+    fclose(fp);
+
+    path = prefix + "_reuse.csv";
+    fp = fopen(path.c_str(), "w");
+    if (!fp) { perror(path.c_str()); return false; }
+    fprintf(fp, "distance,all");
+    for (size_t i = 0; i < mrc.procs.size(); i++) fprintf(fp, ",p%zu", i);
+    fprintf(fp, "\n");
+    auto count = [&](const ReuseStack& s, size_t d) { return d < s.hist.size() ? s.hist[d] / mrc.rate : 0.0; };
+    size_t rows = mrc.all.hist.size();
+    for (const ReuseStack& s : mrc.procs) rows = max(rows, s.hist.size());
+    for (size_t d = 0; d < rows; d++) {
+        bool any = count(mrc.all, d) > 0;
+        for (const ReuseStack& s : mrc.procs) any = any || count(s, d) > 0;
+        if (!any) continue;
+        fprintf(fp, "%ld,%.0f", mrc.scaled(d), count(mrc.all, d));
+        for (const ReuseStack& s : mrc.procs) fprintf(fp, ",%.0f", count(s, d));
+        fprintf(fp, "\n");
+    }
+    fprintf(fp, "cold,%.0f", mrc.all.cold / mrc.rate);
+    for (const ReuseStack& s : mrc.procs) fprintf(fp, ",%.0f", s.cold / mrc.rate);
+    fprintf(fp, "\n");
+    fclose(fp);
+    return true;
+}
+
+void print_mrc() {
+    int frames = max(mrc.curve_end(), total_frames);
+    vector<double> miss = mrc.miss_curve(mrc.all, frames);
+    if (mrc.rate < 1.0) printf("\n==== LRU Miss Ratio Curve (SHARDS %.4f, %ld of %ld accesses, %zu pages sampled) ====\n",
+                               mrc.rate, mrc.all.refs, mrc.total_refs, mrc.all.last.size());
+    else printf("\n==== LRU Miss Ratio Curve (exact, %ld accesses, %zu pages) ====\n", mrc.total_refs, mrc.all.last.size());
+    printf("%-10s %-12s %-10s\n", "Frames", "Est. Faults", "Miss Rate");
+    printf("--------------------------------\n");
+    for (int k = -3; k <= 3; k++) {
+        long c = k < 0 ? total_frames >> -k : (long)total_frames << k;
+        if (c < 1 || c > frames) continue;
+        printf("%-10ld %-12.0f %.2f%%%s\n", c, miss[c] * mrc.total_refs, miss[c] * 100.0,
+               c == total_frames ? "  (current)" : "");
+    }
+    printf("Live %s at %d frames: %ld faults | All reuse hits from %d frames\n", replacer->name(), total_frames,
+           total_page_faults, mrc.curve_end());
+    if (write_mrc_csv(mrc_prefix)) printf("Saved to '%s_mrc.csv', '%s_reuse.csv'\n", mrc_prefix.c_str(), mrc_prefix.c_str());
+}
+
+// 6-0-4. Shared Pages & Copy-on-Write
+// 프로세스마다 따로 셈한 상주 페이지 합(RSS 합)과 실제로 쓰는 프레임 수의 차이가 공유로 아낀 메모리
+void print_sharing() {
+    long saved = share_stats.rss_sum - share_stats.frames_used;
+    if (workload.shared_pages > 0)
+        printf("Shared Region: %d pages (%d%% of accesses) | Resident %ld, avg %.1f mappers | Shared Maps %ld\n",
+               workload.shared_pages, workload.shared_pct, share_stats.shared_resident,
+               share_stats.shared_resident ? (double)share_stats.shared_mappings / share_stats.shared_resident : 0.0,
+               shared_maps);
+    if (fork_tick >= 0)
+        printf("Fork: tick %d, %d children | Inherited %ld pages | COW Copies %ld | Still Shared %ld\n", fork_tick,
+               process_count - 1, cow_inherited, cow_copies, share_stats.cow_shared);
+    printf("Memory: RSS Sum %ld frames | Used %ld frames | Saved %ld frames (%.1f KB, %.1f%%)\n", share_stats.rss_sum,
+           share_stats.frames_used, saved, saved * PAGE_SIZE / 1024.0,
+           share_stats.rss_sum ? saved * 100.0 / share_stats.rss_sum : 0.0);
+}
+
+// 6-1. Policy Comparison (Trace Replay)
+// 실행 중 기록한 접근 Trace를 같은 프레임 수로 정책마다 다시 재생해 Fault 수를 비교함
+// 같은 입력을 쓰므로 OPT(미래 접근을 아는 최적해)와의 차이로 정책을 고를 수 있음
+struct ReplayResult {
+    long faults;
+    long swap_outs;
+};
+
+ReplayResult replay_trace(ReplacementPolicy* policy, const vector<long>& trace) {
+    unordered_map<long, int> resident;       // key -> frame (주소 공간이 희소하므로 해시 사용)
+    vector<long> owner(total_frames, -1);    // frame -> key
+    int next_free = 0; // 커널의 free_frame_list와 같은 순서(0번부터)로 할당
+    ReplayResult r = {0, 0};
+
+    for (size_t i = 0; i < trace.size(); i++) {
+        long key = trace[i];
+        policy->on_access(i);
+        auto found = resident.find(key);
+        if (found != resident.end()) { policy->on_hit(found->second); continue; }
+
+        r.faults++;
+        int frame;
+        if (next_free < total_frames) frame = next_free++;
+        else {
+            frame = policy->victim(key);
+            resident.erase(owner[frame]);
+            r.swap_outs++;
+        }
+        resident[key] = frame;
+        owner[frame] = key;
+        policy->on_load(frame, key);
+    }
+    return r;
+}
+
+void print_policy_comparison(const vector<long>& trace, const string& live_policy) {
+    // OPT용: 각 접근에 대해 같은 페이지가 다음에 접근되는 위치 (없으면 trace.size())
+    vector<size_t> next_use(trace.size());
+    unordered_map<long, size_t> last_seen;
+    for (size_t i = trace.size(); i-- > 0;) {
+        auto found = last_seen.find(trace[i]);
+        next_use[i] = (found != last_seen.end()) ? found->second : trace.size();
+        last_seen[trace[i]] = i;
+    }
+
+    const char* names[] = {"fifo", "lru", "clock", "lfu", "arc", "opt"};
+    ReplayResult results[6];
+    for (int i = 0; i < 6; i++) {
+        ReplacementPolicy* policy = (strcmp(names[i], "opt") == 0) ? new OptPolicy(next_use) : make_policy(names[i]);
+        results[i] = replay_trace(policy, trace);
+        delete policy;
+    }
+    long opt_faults = results[5].faults;
+    size_t n = trace.empty() ? 1 : trace.size();
+
+    printf("\n==== Page Replacement Comparison (%zu accesses, %d frames%s) ====\n", trace.size(), total_frames,
+           huge_pages ? ", 4KB pages only" : "");
+    printf("%-8s %-10s %-10s %-10s %-10s\n", "Policy", "Faults", "Miss Rate", "Swap Outs", "vs OPT");
+    printf("------------------------------------------------------------\n");
+    for (int i = 0; i < 6; i++) {
+        char rate[16];
+        snprintf(rate, sizeof(rate), "%.2f%%", results[i].faults * 100.0 / n);
+        printf("%-8s %-10ld %-10s %-10ld %+.2f%%%s\n", names[i], results[i].faults, rate, results[i].swap_outs,
+               opt_faults ? (results[i].faults - opt_faults) * 100.0 / opt_faults : 0.0,
+               live_policy == names[i] ? "  (live)" : "");
+    }
+}
+
+// 6-2. Multi-CPU Kernel
+// 커널 스레드 여러 개(시뮬레이션 CPU)가 서로 다른 프로세스를 동시에 처리함. 프로세스는 pid % CPU 수 번째 CPU에 고정
+// - 빈 프레임: 처음에는 모두 비어 있고 반납되지 않으므로, 공용 커서를 fetch_add로 FREE_CHUNK씩 떼어 CPU별 캐시에 담아 씀
+// - 교체: CLOCK. hand는 fetch_add, 참조 비트는 atomic, 프레임 선점은 MAPPED -> BUSY CAS (잠금 없음)
+// - Page Table: 프로세스별 mutex. 주인 CPU는 조회/설치 때, 프레임을 빼앗는 CPU는 PTE를 내릴 때만 잡음 (둘을 동시에 잡지 않음)
+// - TLB: CPU별. 다른 CPU가 프레임을 빼앗으면 그 프레임의 주인 key가 바뀌므로, TLB 적중 시 key를 확인해 오래된 항목을 버림
+//   (IPI 없이 다음 사용 시점에 무효화하는 Lazy Shootdown)
+// Swap/상주 집합 관리/Huge Page/대시보드/로그는 단일 CPU 커널에서만 지원
+#define FREE_CHUNK 32
+#define MAX_SIM_CPUS 64
+
+enum FrameState : uint8_t { FRAME_FREE, FRAME_MAPPED, FRAME_BUSY };
+
+struct MtFrame {
+    atomic<long> key{-1};              // page_key(pid, vpn), 비어 있으면 -1
+    atomic<uint8_t> ref{0};            // CLOCK 참조 비트
+    atomic<uint8_t> state{FRAME_FREE};
+};
+
+struct alignas(64) CpuStats {
+    long accesses, faults, steals, remote_steals, stale_tlb, tlb_hits, tlb_misses, walks;
+};
+
+struct ScalingResult {
+    int cpus;
+    double seconds;
+    CpuStats total;
+};
+
+ScalingResult run_multi_cpu(int cpus) {
+    vector<MtFrame> frames(total_frames);
+    atomic<int> free_cursor{0};
+    atomic<unsigned long> hand{0};
+    vector<PCB*> pcbs(process_count);
+    for (int i = 0; i < process_count; i++) {
+        pcbs[i] = new PCB();
+        pcbs[i]->logical_pid = i;
+    }
+    pt_stats = {};
+    vector<CpuStats> stats(cpus);
+    vector<Tlb> tlbs(cpus, tlb); // 전역 TLB 설정을 복사
+    const long vpn_mask = (1L << VPN_BITS) - 1;
+
+    auto cpu_main = [&](int cpu) {
+        CpuStats& st = stats[cpu];
+        st = {};
+        Tlb& ctlb = tlbs[cpu];
+        vector<int> cache;
+        vector<PCB*> mine;
+        for (int i = cpu; i < process_count; i += cpus) mine.push_back(pcbs[i]);
+        // 전체 sim_ticks 배치를 CPU 수로 나눠 처리 (CPU 수와 상관없이 같은 양의 일)
+        long my_batches = sim_ticks / cpus + (cpu < sim_ticks % cpus ? 1 : 0);
+
+        // CLOCK으로 Victim을 골라 선점하고 주인의 PTE를 내림
+        auto steal = [&]() {
+            while (true) {
+                int f = (int)(hand.fetch_add(1, memory_order_relaxed) % total_frames);
+                MtFrame& fr = frames[f];
+                if (fr.state.load(memory_order_acquire) != FRAME_MAPPED) continue;
+                if (fr.ref.load(memory_order_relaxed) && fr.ref.exchange(0, memory_order_relaxed)) continue;
+                uint8_t expected = FRAME_MAPPED;
+                if (!fr.state.compare_exchange_strong(expected, FRAME_BUSY, memory_order_acq_rel)) continue;
+                long key = fr.key.load(memory_order_relaxed);
+                int owner = (int)(key >> VPN_BITS);
+                {
+                    lock_guard<mutex> g(pcbs[owner]->pt_lock);
+                    pcbs[owner]->page_table.evict(key & vpn_mask);
+                }
+                fr.key.store(-1, memory_order_release); // 다른 CPU의 TLB 항목은 이 시점부터 무효
+                if (owner % cpus == cpu) ctlb.invalidate(owner + 1, key & vpn_mask);
+                else st.remote_steals++;
+                st.steals++;
+                return f;
+            }
+        };
+        // 공용 커서가 끝에 닿으면 더 떼어 가지 않음 (Fault마다 fetch_add하면 커서가 int 범위를 넘어 음수 프레임이 나옴)
+        bool free_exhausted = false;
+        auto get_frame = [&]() {
+            if (cache.empty() && !free_exhausted) {
+                int start = free_cursor.fetch_add(FREE_CHUNK, memory_order_relaxed);
+                for (int f = min(total_frames, start + FREE_CHUNK) - 1; f >= start; f--) cache.push_back(f);
+                free_exhausted = start + FREE_CHUNK >= total_frames;
+            }
+            if (cache.empty()) return steal();
+            int f = cache.back();
+            cache.pop_back();
+            return f;
+        };
+
+        PCB* last = nullptr;
+        for (long b = 0; b < my_batches && !mine.empty(); b++) {
+            PCB* p = mine[b % mine.size()];
+            int pid = p->logical_pid;
+            int asid = pid + 1;
+            if (p != last) { ctlb.on_switch(); last = p; }
+            AccessRing* ring = access_ring(pid);
+            uint32_t seq = ring->tail.load(memory_order_relaxed);
+            wait_change(ring->head, ring->kernel_waiting, seq);
+            const AccessRec* recs = ring_batch(ring, seq);
+
+            for (int i = 0; i < batch_size; i++) {
+                long vpn = recs[i].vpn;
+                long key = page_key(pid, vpn);
+                st.accesses++;
+                int f;
+                if (ctlb.enabled() && ctlb.lookup(asid, vpn, &f)) {
+                    MtFrame& fr = frames[f];
+                    if (fr.key.load(memory_order_acquire) == key && fr.state.load(memory_order_acquire) == FRAME_MAPPED) {
+                        if (!fr.ref.load(memory_order_relaxed)) fr.ref.store(1, memory_order_relaxed);
+                        st.tlb_hits++;
+                        continue;
+                    }
+                    ctlb.invalidate(asid, vpn); // 다른 CPU가 빼앗아 간 프레임
+                    st.stale_tlb++;
+                }
+                st.tlb_misses++;
+                st.walks++;
+                int levels;
+                {
+                    lock_guard<mutex> g(p->pt_lock);
+                    f = p->page_table.translate(vpn, &levels);
+                }
+                if (f < 0) {
+                    st.faults++;
+                    f = get_frame();
+                    {
+                        lock_guard<mutex> g(p->pt_lock);
+                        p->page_table.pte(vpn) = {true, false, f, 0};
+                    }
+                    frames[f].key.store(key, memory_order_relaxed);
+                    frames[f].ref.store(1, memory_order_relaxed);
+                    frames[f].state.store(FRAME_MAPPED, memory_order_release);
+                } else if (!frames[f].ref.load(memory_order_relaxed)) {
+                    frames[f].ref.store(1, memory_order_relaxed);
+                }
+                if (ctlb.enabled()) ctlb.insert(asid, vpn, f);
+            }
+            publish(ring->tail, ring->child_waiting);
+        }
+    };
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (int c = 0; c < cpus; c++) workers.emplace_back(cpu_main, c);
+    for (thread& w : workers) w.join();
+    ScalingResult r = {cpus, chrono::duration<double>(chrono::steady_clock::now() - start).count(), {}};
+
+    for (const CpuStats& st : stats) {
+        r.total.accesses += st.accesses; r.total.faults += st.faults;
+        r.total.steals += st.steals; r.total.remote_steals += st.remote_steals;
+        r.total.stale_tlb += st.stale_tlb; r.total.tlb_hits += st.tlb_hits;
+        r.total.tlb_misses += st.tlb_misses; r.total.walks += st.walks;
+    }
+    for (PCB* pcb : pcbs) delete pcb;
+    return r;
+}
+
+// --scaling: 1, 2, 4, ... , N CPU로 같은 양의 일을 처리해 걸린 시간과 처리량 비교
+void print_scaling(const vector<ScalingResult>& results) {
+    printf("\n==== Multi-CPU Scaling (%d processes, %d frames, batch %d, %d batches, host cores %ld) ====\n",
+           process_count, total_frames, batch_size, sim_ticks, sysconf(_SC_NPROCESSORS_ONLN));
+    printf("%-5s %-9s %-13s %-8s %-9s %-9s %-12s %-10s\n", "CPUs", "Time(s)", "Accesses/s", "Speedup", "Faults",
+           "Steals", "Remote", "Stale TLB");
+    printf("------------------------------------------------------------------------------\n");
+    double base = results.empty() ? 0 : results[0].total.accesses / results[0].seconds;
+    for (const ScalingResult& r : results) {
+        double rate = r.seconds > 0 ? r.total.accesses / r.seconds : 0;
+        printf("%-5d %-9.3f %-13.0f %-8s %-9ld %-9ld %-12ld %-10ld\n", r.cpus, r.seconds, rate,
+               (to_string(base > 0 ? rate / base : 0.0).substr(0, 4) + "x").c_str(), r.total.faults, r.total.steals,
+               r.total.remote_steals, r.total.stale_tlb);
+    }
+}
+
+// 6-3. Microbenchmarks (--bench)
+// run_kernel이 접근 하나를 처리하는 경로(Hit, Page Fault + 교체, 로그 기록)를 같은 자료구조로 그대로 따라가며 연산당 시간을 잼
+// IPC와 대시보드는 제외. 각 항목은 소요 시간이 BENCH_MIN_NS 이상이 될 때까지 반복 횟수를 늘려 다시 잼
+#define BENCH_MIN_NS 200000000L
+
+template <typename F>
+void bench_case(const char* name, F body) {
+    long n = 1;
+    while (true) {
+        auto start = chrono::steady_clock::now();
+        body(n);
+        long ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+        if (ns >= BENCH_MIN_NS) {
+            printf("%-36s | %12ld | %10.1f | %14.0f\n", name, n, (double)ns / n, n * 1e9 / ns);
+            return;
+        }
+        long next = ns > 0 ? (long)(n * 1.2 * BENCH_MIN_NS / ns) : n * 100; // 목표의 1.2배 (한 번에 최대 100배)
+        n = min(max(next, n + 1), n * 100);
+    }
+}
+
+// frames개 프레임과 빈 프로세스 P0으로 커널 상태를 초기화
+PCB* reset_bench_kernel(const string& policy, int frames) {
+    free_frame_list.init(frames);
+    frame_table.assign(frames, {-1, -1});
+    delete replacer;
+    replacer = make_policy(policy);
+    return new PCB();
+}
+
+// Page Fault 처리 (run_kernel의 Global Replacement 경로: 빈 프레임 또는 정책 Victim을 회수해 매핑)
+int bench_fault(PCB* p, long vpn) {
+    int pid = p->logical_pid, victim_pid = -1, frame;
+    if (!free_frame_list.empty()) {
+        frame = free_frame_list.pop();
+    } else {
+        frame = replacer->victim(page_key(pid, vpn));
+        victim_pid = frame_table[frame].pid;
+        p->page_table.evict(frame_table[frame].vpn);
+        p->resident_frames--;
+    }
+    PageEntry& entry = p->page_table.pte(vpn);
+    entry.frame_number = frame;
+    entry.valid = true;
+    entry.is_swapped = false;
+    p->resident_frames++;
+    p->page_fault_count++;
+    frame_table[frame] = {pid, vpn};
+    replacer->on_load(frame, page_key(pid, vpn));
+    if (victim_pid >= 0) trace_event(REC_FAULT_SWAP, 0, pid, vpn, frame, victim_pid);
+    else trace_event(REC_FAULT_NEW, 0, pid, vpn, frame);
+    return frame;
+}
+
+void run_benchmarks(const string& policy) {
+    // P0의 모든 페이지를 섞은 순서로 접근
+    vector<long> vpns(process_pages);
+    for (int i = 0; i < process_pages; i++) vpns[i] = page_to_vpn(i);
+    for (int i = process_pages - 1; i > 0; i--) swap(vpns[i], vpns[rand() % (i + 1)]);
+    long sink = 0;
+
+    printf("Microbenchmarks (policy %s, %d pages, %d frames, TLB %d entries, >= %ld ms per case)\n", policy.c_str(),
+           process_pages, total_frames, tlb.entries(), BENCH_MIN_NS / 1000000);
+    printf("%-36s | %12s | %10s | %14s\n", "Benchmark", "Ops", "ns/op", "ops/sec");
+    printf("--------------------------------------------------------------------------------\n");
+
+    // 1. Hit: 모든 페이지가 상주 (로그는 끄고 경로 비용만)
+    log_mode = LOG_NONE;
+    int resident = min(process_pages, total_frames);
+    PCB* p = reset_bench_kernel(policy, total_frames);
+    for (int i = 0; i < resident; i++) bench_fault(p, vpns[i]);
+    bench_case("hit path (page walk)", [&](long n) {
+        for (long i = 0; i < n; i++) {
+            long vpn = vpns[i % resident];
+            int levels;
+            int frame = p->page_table.translate(vpn, &levels);
+            replacer->on_hit(frame);
+            trace_event(REC_HIT, 0, 0, vpn, frame);
+            sink += frame;
+        }
+    });
+    if (tlb.enabled()) {
+        // TLB 용량의 절반만 반복 접근해 대부분 TLB에서 변환
+        int hot = max(1, min(resident, tlb.entries() / 2));
+        bench_case("hit path (tlb)", [&](long n) {
+            for (long i = 0; i < n; i++) {
+                long vpn = vpns[i % hot];
+                int frame, levels;
+                if (!tlb.lookup(1, vpn, &frame)) {
+                    frame = p->page_table.translate(vpn, &levels);
+                    tlb.insert(1, vpn, frame);
+                }
+                replacer->on_hit(frame);
+                trace_event(REC_TLB_HIT, 0, 0, vpn, frame);
+                sink += frame;
+            }
+        });
     }
+    delete p;
+
+    // 2. Page Fault + 교체: 페이지 수의 절반만큼의 프레임으로 모든 페이지를 순서대로 반복 접근 (fifo/lru/clock은 매번 Fault)
+    int fault_frames = max(1, resident / 2);
+    p = reset_bench_kernel(policy, fault_frames);
+    string fault_name = "page fault + " + policy + " replacement";
+    bench_case(fault_name.c_str(), [&](long n) {
+        for (long i = 0; i < n; i++) {
+            long vpn = vpns[i % resident];
+            int levels;
+            int frame = p->page_table.translate(vpn, &levels);
+            if (frame >= 0) replacer->on_hit(frame);
+            else frame = bench_fault(p, vpn);
+            sink += frame;
+        }
+    });
+    delete p;
+
+    // 3. 로그 기록: 커널 쪽 trace_event + Tick 끝 flush_trace (텍스트 변환은 백그라운드 스레드가 /dev/null에 기록)
+    FILE* null_fp = fopen("/dev/null", "w");
+    if (!null_fp) { perror("file open failed"); return; }
+    log_mode = LOG_TEXT;
+    log_level = LEVEL_ALL;
+    trace_writer.start(null_fp);
+    bench_case("trace_event + flush_trace (text)", [&](long n) {
+        for (long i = 0; i < n; i++) {
+            trace_event(REC_HIT, (int)(i / ACCESS_PER_TICK), 0, vpns[i % process_pages], (int)(i % total_frames));
+            if (i % ACCESS_PER_TICK == ACCESS_PER_TICK - 1) flush_trace();
+        }
+        flush_trace();
+    });
+    trace_writer.finish();
+    fclose(null_fp);
+
+    // 4. 백그라운드 스레드가 레코드 하나를 텍스트로 바꾸는 비용
+    string text;
+    TraceRec rec = {};
+    rec.type = REC_HIT;
+    bench_case("render_record (text)", [&](long n) {
+        for (long i = 0; i < n; i++) {
+            rec.tick = (int)i;
+            rec.vpn = vpns[i % process_pages];
+            render_record(rec, text);
+            if (text.size() > (1 << 20)) text.clear();
+        }
+    });
+    if (sink == 42) printf(" \n"); // 최적화로 측정 루프가 사라지지 않도록 결과 사용
+}
+
+void print_usage(const char* prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("  -p, --policy P   페이지 교체 정책: fifo(기본값) | lru | clock | lfu | arc\n");
+    printf("  -t, --ticks N    시뮬레이션 Tick 수 (기본값 %d)\n", SIMULATION_TICKS);
+    printf("  -H, --headless   대시보드와 Tick 지연 없이 최대 속도로 실행\n");
+    printf("  -d, --delay MS   대화형 모드의 Tick당 지연 (기본값 100ms, 0이면 최대 속도)\n");
+    printf("  -r, --refresh MS 대시보드 갱신 주기 (기본값 200ms)\n");
+    printf("      --tlb-entries N  TLB 항목 수 (기본값 64, 0이면 TLB 없음)\n");
+    printf("      --tlb-ways N     TLB Associativity (기본값 4, 항목 수의 약수)\n");
+    printf("      --tlb-flush      ASID 태그 대신 Context Switch마다 TLB 전체 Flush\n");
+    printf("      --tlb-repl R     TLB 교체 방식: lru(기본값) | fifo | random\n");
+    printf("  -n, --procs N    사용자 프로세스 수 (기본값 %d)\n", PROCESS_COUNT);
+    printf("  -f, --frames N   물리 프레임 수 (기본값 %d = 2MB)\n", TOTAL_FRAMES);
+    printf("  -P, --pages N    프로세스당 사용하는 가상 페이지 수 (기본값 %d, 4개의 떨어진 영역에 분산)\n", VIRTUAL_PAGES);
+    printf("  -G, --huge       비어 있는 2MB 영역은 연속 512 프레임으로 한 번에 매핑 (회수 시 4KB로 분할)\n");
+    printf("  -w, --workload W 접근 패턴: uniform(기본값) | ws | zipf | seq | loop | trace\n");
+    printf("  -T, --trace FILE lackey/perf 주소 Trace 파일을 mmap해 재생 (--workload trace)\n");
+    printf("      --ws-size N      Working Set 크기 (기본값 페이지 수의 1/10)\n");
+    printf("      --ws-phase N     Working Set Phase 길이, 접근 수 (기본값 2000)\n");
+    printf("      --zipf-s X       Zipf 지수 (기본값 0.99)\n");
+    printf("      --scan-run N     순차 Scan 한 번의 길이 (기본값 64)\n");
+    printf("      --loop-len N     Loop 길이 (기본값 페이지 수)\n");
+    printf("  -S, --swap       실제 Swap 파일과 지연 모델 사용 (Fault 난 프로세스는 Swap In이 끝날 때까지 대기)\n");
+    printf("      --swap-file PATH Swap 파일 경로 (기본값 vm_swap.img, 실행 중에만 존재)\n");
+    printf("      --swap-latency US 디스크 요청당 지연 (기본값 5000us, 1 Tick = %dus)\n", TICK_US);
+    printf("      --swap-transfer US 페이지당 전송 시간 (기본값 100us)\n");
+    printf("      --prefetch N     Swap In 할 때 뒤쪽 페이지 N개를 함께 읽음 (기본값 0)\n");
+    printf("      --write-pct P    합성 패턴의 쓰기 접근 비율 (기본값 30%%)\n");
+    printf("      --mem-latency NS 메모리 접근 시간, EAT 계산용 (기본값 100ns)\n");
+    printf("  -A, --alloc M    상주 집합 관리: global(기본값) | local(균등 할당, 자기 프레임만 교체) | ws | pff\n");
+    printf("      --ws-window N    Working Set Window, 프로세스별 접근 수 (기본값 500)\n");
+    printf("      --pff-low P / --pff-high P  PFF 하한/상한 Fault 비율 (기본값 2%% / 10%%)\n");
+    printf("      --pff-interval N PFF 측정 구간, 접근 수 (기본값 100)\n");
+    printf("  -c, --load-control 요구량 합이 프레임 수를 넘으면 프로세스를 중단해 Thrashing 방지\n");
+    printf("  -W, --fault-window T 구간별 프로세스 Fault 비율 표 출력 (T Tick 단위, local/ws/pff/Load Control이면 기본값 전체의 1/10)\n");
+    printf("  -b, --batch N    한 번 실행될 때 처리하는 접근 수 (기본값 %d, msgq는 최대 %d)\n", ACCESS_PER_TICK, MSGQ_MAX_BATCH);
+    printf("  -x, --transport K 접근 배치 전달 방식: msgq(기본값) | shm (자식별 공유 메모리 링 + futex)\n");
+    printf("  -M, --cpus N     커널 스레드 N개가 서로 다른 프로세스를 동시에 처리 (CLOCK, shm, Headless 전용)\n");
+    printf("      --scaling        1, 2, 4, ... , --cpus 개 CPU로 같은 일을 처리해 처리량 비교\n");
+    printf("      --shared N       모든 프로세스가 같은 주소에 매핑하는 공유 영역 N 페이지 (한 프레임을 함께 매핑)\n");
+    printf("      --shared-pct P   공유 영역 접근 비율 (기본값 20%%)\n");
+    printf("      --fork T         P0만 실행하다가 Tick T에 fork해 나머지 프로세스를 만듦 (Copy-on-Write)\n");
+    printf("  -R, --mrc PREFIX 재사용 거리로 모든 프레임 수의 LRU Miss Ratio를 한 번에 계산해 PREFIX_mrc.csv, PREFIX_reuse.csv로 저장\n");
+    printf("      --shards R       SHARDS 표본 비율 (0 < R <= 1, 기본값 1 = 정확한 계산)\n");
+    printf("  -l, --log M      로그 파일 형식: text(기본값, vm_final_dump.txt) | binary (vm_final_dump.bin) | none\n");
+    printf("  -L, --log-level V 기록할 이벤트: all(기본값) | fault (Hit은 집계만) | none\n");
+    printf("  -z, --compress   바이너리 로그를 delta + varint로 압축\n");
+    printf("  -D, --decode FILE 바이너리 로그를 텍스트 형식으로 stdout에 출력하고 종료\n");
+    printf("  -C, --compare    종료 후 기록한 접근 Trace를 모든 정책과 OPT로 재생해 Fault 수 비교\n");
+    printf("      --bench          Hit, Page Fault + 교체, 로그 기록 경로의 연산당 시간(ns/op, ops/sec)을 측정하고 종료\n");
+    printf("  -h, --help       도움말 출력\n");
 }
 
 // 7. Main
-int main() {
+int main(int argc, char* argv[]) {
+    static const struct option long_opts[] = {
+        {"policy",  required_argument, NULL, 'p'},
+        {"ticks",   required_argument, NULL, 't'},
+        {"headless", no_argument,      NULL, 'H'},
+        {"delay",   required_argument, NULL, 'd'},
+        {"refresh", required_argument, NULL, 'r'},
+        {"compare", no_argument,       NULL, 'C'},
+        {"log",     required_argument, NULL, 'l'},
+        {"log-level", required_argument, NULL, 'L'},
+        {"compress", no_argument,      NULL, 'z'},
+        {"decode",  required_argument, NULL, 'D'},
+        {"procs",   required_argument, NULL, 'n'},
+        {"frames",  required_argument, NULL, 'f'},
+        {"pages",   required_argument, NULL, 'P'},
+        {"huge",    no_argument,       NULL, 'G'},
+        {"tlb-entries", required_argument, NULL, 1000},
+        {"tlb-ways",    required_argument, NULL, 1001},
+        {"tlb-flush",   no_argument,       NULL, 1002},
+        {"tlb-repl",    required_argument, NULL, 1003},
+        {"workload", required_argument, NULL, 'w'},
+        {"trace",    required_argument, NULL, 'T'},
+        {"ws-size",  required_argument, NULL, 1004},
+        {"ws-phase", required_argument, NULL, 1005},
+        {"zipf-s",   required_argument, NULL, 1006},
+        {"scan-run", required_argument, NULL, 1007},
+        {"loop-len", required_argument, NULL, 1008},
+        {"swap",          no_argument,       NULL, 'S'},
+        {"swap-file",     required_argument, NULL, 1009},
+        {"swap-latency",  required_argument, NULL, 1010},
+        {"swap-transfer", required_argument, NULL, 1011},
+        {"prefetch",      required_argument, NULL, 1012},
+        {"write-pct",     required_argument, NULL, 1013},
+        {"mem-latency",   required_argument, NULL, 1014},
+        {"alloc",         required_argument, NULL, 'A'},
+        {"ws-window",     required_argument, NULL, 1015},
+        {"pff-low",       required_argument, NULL, 1016},
+        {"pff-high",      required_argument, NULL, 1017},
+        {"pff-interval",  required_argument, NULL, 1018},
+        {"load-control",  no_argument,       NULL, 'c'},
+        {"fault-window",  required_argument, NULL, 'W'},
+        {"batch",         required_argument, NULL, 'b'},
+        {"transport",     required_argument, NULL, 'x'},
+        {"cpus",          required_argument, NULL, 'M'},
+        {"scaling",       no_argument,       NULL, 1020},
+        {"mrc",           required_argument, NULL, 'R'},
+        {"shards",        required_argument, NULL, 1021},
+        {"shared",        required_argument, NULL, 1022},
+        {"shared-pct",    required_argument, NULL, 1023},
+        {"fork",          required_argument, NULL, 1024},
+        {"bench",         no_argument,       NULL, 1025},
+        {"help",    no_argument,       NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    string policy = "fifo";
+    int tlb_entries = 64, tlb_ways = 4;
+    bool tlb_asid = true;
+    TlbReplacement tlb_repl = TLB_LRU;
+    bool use_swap = false;
+    int sim_cpus = 1;
+    bool scaling = false;
+    double shards_rate = 1.0;
+    int opt;
+    bool policy_given = false;
+    bool bench = false;
+    while ((opt = getopt_long(argc, argv, "p:t:Hd:r:Cn:f:P:Gl:L:zD:w:T:SA:cW:b:x:M:R:h", long_opts, NULL)) != -1) {
+        switch (opt) {
+            case 'p': policy = optarg; policy_given = true; break;
+            case 't': sim_ticks = atoi(optarg); break;
+            case 'H': headless = true; break;
+            case 'd': tick_delay_ms = atoi(optarg); break;
+            case 'r': refresh_ms = atoi(optarg); break;
+            case 'C': compare_policies = true; break;
+            case 'n': process_count = atoi(optarg); break;
+            case 'f': total_frames = atoi(optarg); break;
+            case 'P': process_pages = atoi(optarg); break;
+            case 'G': huge_pages = true; break;
+            case 'l':
+                if (strcmp(optarg, "text") == 0) log_mode = LOG_TEXT;
+                else if (strcmp(optarg, "binary") == 0) log_mode = LOG_BINARY;
+                else if (strcmp(optarg, "none") == 0) log_mode = LOG_NONE;
+                else { fprintf(stderr, "unknown log mode: %s\n", optarg); return 1; }
+                break;
+            case 'L':
+                if (strcmp(optarg, "all") == 0) log_level = LEVEL_ALL;
+                else if (strcmp(optarg, "fault") == 0) log_level = LEVEL_FAULT;
+                else if (strcmp(optarg, "none") == 0) log_level = LEVEL_NONE;
+                else { fprintf(stderr, "unknown log level: %s\n", optarg); return 1; }
+                break;
+            case 'z': compress_trace = true; break;
+            case 'D': return decode_trace(optarg);
+            case 1000: tlb_entries = atoi(optarg); break;
+            case 1001: tlb_ways = atoi(optarg); break;
+            case 1002: tlb_asid = false; break;
+            case 1003:
+                if (strcmp(optarg, "lru") == 0) tlb_repl = TLB_LRU;
+                else if (strcmp(optarg, "fifo") == 0) tlb_repl = TLB_FIFO;
+                else if (strcmp(optarg, "random") == 0) tlb_repl = TLB_RANDOM;
+                else { fprintf(stderr, "unknown tlb replacement: %s\n", optarg); return 1; }
+                break;
+            case 'w':
+                if (!parse_workload(optarg, &workload.type)) { fprintf(stderr, "unknown workload: %s\n", optarg); return 1; }
+                break;
+            case 'T': workload.trace_path = optarg; workload.type = WL_TRACE; break;
+            case 1004: workload.ws_size = atoi(optarg); break;
+            case 1005: workload.ws_phase = atoi(optarg); break;
+            case 1006: workload.zipf_s = atof(optarg); break;
+            case 1007: workload.scan_run = atoi(optarg); break;
+            case 1008: workload.loop_len = atoi(optarg); break;
+            case 'S': use_swap = true; break;
+            case 1009: swap_path = optarg; break;
+            case 1010: swap_dev.latency_us = atoi(optarg); break;
+            case 1011: swap_dev.transfer_us = atoi(optarg); break;
+            case 1012: prefetch_pages = atoi(optarg); break;
+            case 1013: workload.write_pct = atoi(optarg); break;
+            case 1014: mem_latency_ns = atoi(optarg); break;
+            case 'A':
+                if (strcmp(optarg, "global") == 0) alloc_mode = ALLOC_GLOBAL;
+                else if (strcmp(optarg, "local") == 0) alloc_mode = ALLOC_LOCAL;
+                else if (strcmp(optarg, "ws") == 0) alloc_mode = ALLOC_WS;
+                else if (strcmp(optarg, "pff") == 0) alloc_mode = ALLOC_PFF;
+                else { fprintf(stderr, "unknown allocation mode: %s\n", optarg); return 1; }
+                break;
+            case 1015: ws_window = atoi(optarg); break;
+            case 1016: pff_low = atoi(optarg); break;
+            case 1017: pff_high = atoi(optarg); break;
+            case 1018: pff_interval = atoi(optarg); break;
+            case 'c': load_control = true; break;
+            case 'W': fault_window = atoi(optarg); break;
+            case 'b': batch_size = atoi(optarg); break;
+            case 'M': sim_cpus = atoi(optarg); break;
+            case 1020: scaling = true; break;
+            case 'R': mrc_prefix = optarg; break;
+            case 1021: shards_rate = atof(optarg); break;
+            case 1022: workload.shared_pages = atoi(optarg); break;
+            case 1023: workload.shared_pct = atoi(optarg); break;
+            case 1024: fork_tick = atoi(optarg); break;
+            case 1025: bench = true; break;
+            case 'x':
+                if (strcmp(optarg, "msgq") == 0) transport = TRANSPORT_MSGQ;
+                else if (strcmp(optarg, "shm") == 0) transport = TRANSPORT_SHM;
+                else { fprintf(stderr, "unknown transport: %s\n", optarg); return 1; }
+                break;
+            case 'h': print_usage(argv[0]); return 0;
+            default:  print_usage(argv[0]); return 1;
+        }
+    }
+    if (process_count <= 0 || total_frames <= 0 || process_pages <= 0) { fprintf(stderr, "invalid size\n"); return 1; }
+    if (policy == "opt") { fprintf(stderr, "opt needs future accesses; use --compare to replay the trace with OPT\n"); return 1; }
+    replacer = make_policy(policy);
+    if (!replacer) { fprintf(stderr, "unknown policy: %s\n", policy.c_str()); return 1; }
+    if (sim_ticks <= 0) { fprintf(stderr, "invalid tick count\n"); return 1; }
+    if (tick_delay_ms < 0 || refresh_ms <= 0) { fprintf(stderr, "invalid delay\n"); return 1; }
+    if (headless) tick_delay_ms = 0;
+    if (!tlb.configure(tlb_entries, tlb_ways, tlb_asid, tlb_repl)) { fprintf(stderr, "invalid tlb geometry\n"); return 1; }
+    if (bench) { run_benchmarks(policy); return 0; }
+    if (workload.type == WL_TRACE) {
+        if (workload.trace_path.empty()) { fprintf(stderr, "--workload trace needs --trace FILE\n"); return 1; }
+        if (!trace_file.open(workload.trace_path)) return 1;
+    }
+    if (workload.zipf_s <= 0) { fprintf(stderr, "invalid workload parameter\n"); return 1; }
+    if (swap_dev.latency_us < 0 || swap_dev.transfer_us < 0 || prefetch_pages < 0 || prefetch_pages >= total_frames ||
+        mem_latency_ns <= 0) {
+        fprintf(stderr, "invalid swap parameter\n");
+        return 1;
+    }
+    if (ws_window <= 0 || pff_interval <= 0 || pff_low < 0 || pff_high < pff_low || fault_window < 0) {
+        fprintf(stderr, "invalid allocation parameter\n");
+        return 1;
+    }
+    if (fault_window == 0 && (alloc_mode != ALLOC_GLOBAL || load_control)) fault_window = max(1, sim_ticks / 10);
+    if (workload.shared_pages < 0 || workload.shared_pages > MAX_SHARED_PAGES || workload.shared_pct < 0 ||
+        workload.shared_pct > 100 || fork_tick < -1 || fork_tick >= sim_ticks) {
+        fprintf(stderr, "invalid sharing parameter\n");
+        return 1;
+    }
+    bool sharing = workload.shared_pages > 0 || fork_tick >= 0;
+    if (sharing && (use_swap || alloc_mode != ALLOC_GLOBAL || load_control || huge_pages)) {
+        fprintf(stderr, "--shared/--fork do not support --swap, --alloc, --load-control or --huge\n");
+        return 1;
+    }
+    bool multi_cpu = sim_cpus > 1 || scaling;
+    if (sim_cpus < 1 || sim_cpus > MAX_SIM_CPUS) { fprintf(stderr, "invalid cpu count (1-%d)\n", MAX_SIM_CPUS); return 1; }
+    if (multi_cpu) {
+        if (policy_given && policy != "clock") { fprintf(stderr, "--cpus supports --policy clock only\n"); return 1; }
+        if (use_swap || alloc_mode != ALLOC_GLOBAL || load_control || huge_pages || compare_policies || !mrc_prefix.empty() ||
+            sharing) {
+            fprintf(stderr, "--cpus does not support --swap, --alloc, --load-control, --huge, --compare, --mrc, --shared or --fork\n");
+            return 1;
+        }
+        sim_cpus = min(sim_cpus, process_count);
+        if (total_frames < sim_cpus * FREE_CHUNK * 2) { fprintf(stderr, "--cpus needs at least %d frames\n", sim_cpus * FREE_CHUNK * 2); return 1; }
+        delete replacer;
+        replacer = make_policy("clock");
+        transport = TRANSPORT_SHM; // 커널 스레드가 각자 자식의 링을 직접 읽음
+        headless = true;
+        tick_delay_ms = 0;
+        log_mode = LOG_NONE;
+    }
+    if (shards_rate <= 0 || shards_rate > 1) { fprintf(stderr, "invalid shards rate (0 < R <= 1)\n"); return 1; }
+    if (!mrc_prefix.empty()) mrc.init(process_count, shards_rate);
+    if (use_swap && !swap_dev.open(swap_path.c_str(), total_frames)) return 1;
+    if (batch_size <= 0 || (transport == TRANSPORT_MSGQ && batch_size > MSGQ_MAX_BATCH)) {
+        fprintf(stderr, "invalid batch size (msgq: 1-%d, larger batches need --transport shm)\n", MSGQ_MAX_BATCH);
+        return 1;
+    }
+    if (transport == TRANSPORT_SHM && !setup_access_rings(process_count)) return 1;
+
     q1_id = msgget(KEY_Q1, IPC_CREAT | 0666);
     q2_id = msgget(KEY_Q2, IPC_CREAT | 0666);
     msgctl(q1_id, IPC_RMID, NULL); msgctl(q2_id, IPC_RMID, NULL);
     q1_id = msgget(KEY_Q1, IPC_CREAT | 0666); q2_id = msgget(KEY_Q2, IPC_CREAT | 0666);
 
-    log_fp = fopen("vm_final_dump.txt", "w");
-    if (!log_fp) { perror("fopen"); return 1; }
+    const char* log_path = (log_mode == LOG_BINARY) ? "vm_final_dump.bin" : "vm_final_dump.txt";
+    FILE* log_fp = NULL;
+    if (log_mode != LOG_NONE) {
+        log_fp = fopen(log_path, log_mode == LOG_BINARY ? "wb" : "w");
+        if (!log_fp) { perror("fopen"); return 1; }
+    }
 
-    pid_t pids[PROCESS_COUNT];
+    vector<pid_t> pids(process_count);
     cout << "OS Simulation Starting..." << endl;
 
-    for (int i = 0; i < PROCESS_COUNT; i++) {
+    for (int i = 0; i < process_count; i++) {
         pids[i] = fork();
         if (pids[i] == 0) { run_child(i); exit(0); }
+        if (pids[i] < 0) { perror("fork"); process_count = i; break; }
     }
 
-    run_kernel();
+    // 기록 스레드는 fork 이후에 시작해야 함
+    if (log_fp) trace_writer.start(log_fp);
+    auto kernel_start = chrono::steady_clock::now();
+    vector<ScalingResult> scaling_results;
+    if (multi_cpu) {
+        vector<int> counts;
+        for (int c = 1; scaling && c < sim_cpus; c *= 2) counts.push_back(c);
+        counts.push_back(sim_cpus);
+        for (int c : counts) scaling_results.push_back(run_multi_cpu(c));
+        // 아래 요약은 마지막(가장 많은 CPU) 실행 기준
+        const ScalingResult& last = scaling_results.back();
+        total_access = last.total.accesses;
+        total_page_faults = last.total.faults;
+        total_swap_outs = last.total.steals;
+        total_page_walks = last.total.walks;
+        walk_levels = last.total.walks * PT_LEVELS; // Huge Page를 쓰지 않으므로 항상 4단계
+        tlb.hits = last.total.tlb_hits;
+        tlb.misses = last.total.tlb_misses;
+        tlb.shootdowns = last.total.stale_tlb;
+    } else {
+        run_kernel();
+    }
+    double kernel_sec = multi_cpu ? scaling_results.back().seconds
+                                  : chrono::duration<double>(chrono::steady_clock::now() - kernel_start).count();
+    trace_writer.finish();
 
-    for (int i = 0; i < PROCESS_COUNT; i++) kill(pids[i], SIGKILL);
+    for (int i = 0; i < process_count; i++) { kill(pids[i], SIGKILL); waitpid(pids[i], NULL, 0); }
     msgctl(q1_id, IPC_RMID, NULL); msgctl(q2_id, IPC_RMID, NULL);
-    fclose(log_fp);
-
-    cout << "\nSimulation Completed. Log saved to 'vm_final_dump.txt'" << endl;
+    release_access_rings();
+    if (log_fp) {
+        fclose(log_fp);
+        printf("\nSimulation Completed. Log saved to '%s' (%.1f KB)\n", log_path, trace_writer.bytes_written / 1024.0);
+    } else {
+        printf("\nSimulation Completed.\n");
+    }
+    printf("Policy: %s | Accesses: %ld | Hits: %ld | Page Faults: %ld (%.2f%%) | Swap Outs: %ld\n", replacer->name(),
+           total_access, total_access - total_page_faults, total_page_faults,
+           total_access ? total_page_faults * 100.0 / total_access : 0.0, total_swap_outs);
+    printf("Transport: %s, batch %d | Kernel Time: %.3f s | Throughput: %.0f accesses/s\n",
+           transport == TRANSPORT_SHM ? "shm" : "msgq", batch_size, kernel_sec, kernel_sec > 0 ? total_access / kernel_sec : 0.0);
+    if (tlb.enabled()) {
+        long lookups = tlb.hits + tlb.misses;
+        printf("TLB: %d entries, %d-way, %s | Hit Rate: %.2f%% | Page Walks: %ld | Context Switches: %ld | Flushes: %ld | Shootdowns: %ld | Reach: %d KB\n",
+               tlb.entries(), tlb.associativity(), tlb.mode(), lookups ? tlb.hits * 100.0 / lookups : 0.0,
+               total_page_walks, context_switches, tlb.flushes, tlb.shootdowns, tlb.entries() * PAGE_SIZE / 1024);
+    }
+    if (swap_dev.enabled()) print_swap_stats();
+    if (alloc_mode != ALLOC_GLOBAL || load_control || fault_window > 0) print_fault_windows();
+    print_page_table_footprint();
+    if (workload.shared_pages > 0 || fork_tick >= 0) print_sharing();
+    if (mrc.enabled()) print_mrc();
+    if (compare_policies) print_policy_comparison(access_trace, policy);
+    if (multi_cpu) print_scaling(scaling_results);
+    swap_dev.close();
+    delete replacer;
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,860 @@
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <climits>
+#include <getopt.h>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+// Term 3: 스케줄러 + 가상 메모리 통합 시뮬레이션
+// term1의 PCB/Ready Queue/Wait Queue(타이밍 휠) 스케줄링과 term2의 Radix Page Table/frame_table을 한 프로세스 안에서 결합함
+// Page Fault가 나면 프로세스는 Paging 디스크 읽기가 끝날 때까지 Block되고 스케줄러는 다른 프로세스를 실행함
+// 다중 프로그래밍 정도를 높여 가며 CPU 이용률이 올라가다가 Thrashing으로 무너지는 과정을 측정함
+
+// 1. 시스템 상수 및 설정
+#define CHILD_COUNT 10       // 사용자 프로세스 수
+#define T_QUANTUM 3          // Time Quantum (Time Slice)
+#define SIM_LIMIT 10000      // 시뮬레이션 종료 시간 (Tick)
+#define WHEEL_SLOTS 64       // Wait Queue 타이밍 휠 슬롯 수 (2의 거듭제곱)
+
+// 스케줄링 정책 파라미터 (term1과 같음)
+#define MLFQ_LEVELS 3        // MLFQ 우선순위 단계 수 (단계 k의 Quantum = T_QUANTUM * 2^k)
+#define MLFQ_BOOST 100       // MLFQ 전체 우선순위 초기화 주기 (Tick)
+#define CFS_LATENCY 12       // CFS 목표 스케줄링 주기 (Tick)
+#define CFS_MIN_GRAN 1       // CFS 최소 Time Slice (Tick)
+#define CFS_WAKEUP_GRAN 2    // CFS 깨어난 프로세스의 선점 허용 vruntime 차이
+
+// Paging (term2와 같은 x86-64 방식 4단계)
+#define PAGE_SHIFT 12
+#define PT_LEVELS 4
+#define PT_BITS 9
+#define PT_ENTRIES (1 << PT_BITS)
+#define HEAP_BASE_VPN (0x10000000L >> PAGE_SHIFT) // 사용 페이지 0번의 VPN
+
+// 메모리 워크로드 기본값
+#define TOTAL_FRAMES 128     // 물리 프레임 수
+#define PROC_PAGES 64        // 프로세스당 가상 페이지 수
+#define WS_PAGES 16          // Working Set 크기
+#define WS_LOCALITY 99       // Working Set 안을 접근할 확률 (%)
+#define WS_PHASE 5000        // Working Set 위치가 바뀌는 주기 (프로세스 자신의 접근 수)
+#define REFS_PER_TICK 4      // 실행 Tick당 메모리 접근 수
+#define FAULT_TICKS 8        // Paging 디스크가 페이지 하나를 읽는 시간 (Tick)
+#define WS_WINDOW 200        // Load Control용 Working Set Window (접근 수)
+
+// 2. 데이터 구조
+
+// 2-1. Radix Page Table (term2와 같은 4단계 구조, 필요한 테이블만 생성, Huge Page 없음)
+struct PageEntry {
+    bool valid;
+    int frame_number;
+};
+struct PtLeaf { PageEntry pte[PT_ENTRIES]; };
+struct PtPmd  { PtLeaf* leaf[PT_ENTRIES]; };
+struct PtPud  { PtPmd* pmd[PT_ENTRIES]; };
+struct PtPgd  { PtPud* pud[PT_ENTRIES]; };
+
+class RadixPageTable {
+    PtPgd* pgd = nullptr;
+
+    static int index(long vpn, int level) { return (vpn >> ((PT_LEVELS - 1 - level) * PT_BITS)) & (PT_ENTRIES - 1); }
+
+public:
+    ~RadixPageTable() {
+        if (!pgd) return;
+        for (PtPud* pud : pgd->pud) {
+            if (!pud) continue;
+            for (PtPmd* pmd : pud->pmd) {
+                if (!pmd) continue;
+                for (PtLeaf* leaf : pmd->leaf) delete leaf;
+                delete pmd;
+            }
+            delete pud;
+        }
+        delete pgd;
+    }
+
+    // Page Walk: 유효한 매핑이면 프레임 번호 반환 (없으면 -1)
+    int translate(long vpn) const {
+        if (!pgd) return -1;
+        PtPud* pud = pgd->pud[index(vpn, 0)];
+        if (!pud) return -1;
+        PtPmd* pmd = pud->pmd[index(vpn, 1)];
+        if (!pmd) return -1;
+        PtLeaf* leaf = pmd->leaf[index(vpn, 2)];
+        if (!leaf || !leaf->pte[index(vpn, 3)].valid) return -1;
+        return leaf->pte[index(vpn, 3)].frame_number;
+    }
+
+    // 4KB PTE (경로상의 테이블은 필요할 때 생성)
+    PageEntry& pte(long vpn) {
+        if (!pgd) pgd = new PtPgd();
+        PtPud*& pud = pgd->pud[index(vpn, 0)];
+        if (!pud) pud = new PtPud();
+        PtPmd*& pmd = pud->pmd[index(vpn, 1)];
+        if (!pmd) pmd = new PtPmd();
+        PtLeaf*& leaf = pmd->leaf[index(vpn, 2)];
+        if (!leaf) leaf = new PtLeaf();
+        return leaf->pte[index(vpn, 3)];
+    }
+};
+
+// Block 이유
+enum WaitReason {
+    WAIT_NONE,
+    WAIT_IO,    // CPU Burst를 마치고 요청한 장치 I/O
+    WAIT_PAGE   // Page Fault: Paging 디스크에서 페이지를 읽는 중
+};
+
+// 프로세스 제어 블록 (PCB): term1의 스케줄링 필드 + term2의 메모리 필드
+struct ProcInfo {
+    int pid;            // 프로세스 번호 (1부터, p_table 인덱스 + 1)
+    int cpu_time;       // 현재 CPU Burst의 남은 실행 Tick
+    int io_done;        // Block 해제 예정 시각 (Tick)
+    bool is_waiting;    // Blocked 상태 여부
+    WaitReason wait;
+    int mlfq_level;     // MLFQ 현재 우선순위 단계
+    long vruntime;      // CFS 가상 실행 시간
+    int ready_since;    // Ready Queue 진입 시각 (대기 시간 계산용)
+    int burst_start;    // 현재 CPU Burst가 Ready 상태가 된 시각
+    bool responded;     // 현재 Burst에서 Dispatch된 적이 있는지 여부
+    bool in_rq;         // Run Queue에 들어 있음 (Load Control로 중단된 프로세스는 꺼낼 때 건너뜀)
+
+    // 메모리
+    RadixPageTable* page_table;
+    int resident;       // 상주 페이지 수
+    long retry_vpn;     // Page In이 끝난 뒤 다시 실행할 접근 (-1이면 없음)
+    int pending_frame;  // Page In 중인 프레임 (-1이면 빈 프레임을 기다림)
+    uint64_t rng;       // 프로세스별 난수열 (버스트/I/O 시간/접근 패턴)
+    int ws_base;        // 현재 Working Set 시작 페이지
+    long refs;          // 지금까지 실행한 접근 수
+
+    // Load Control (Working Set 추정)
+    bool suspended;
+    std::deque<long> ws_refs;
+    std::unordered_map<long, int> ws_count;
+    int wss;
+
+    // 프로세스별 성능 지표
+    long cpu_ticks;         // 접근을 모두 마친(진행한) Tick 수
+    long faults;
+    long bursts;
+    long fault_wait_sum;    // Page In 대기 시간 합
+};
+
+// 정책 비교용 통계 (term1과 같은 정의: CPU Burst = Ready 진입부터 I/O 요청까지, Page In 대기 포함)
+struct SchedStats {
+    long bursts;
+    long total_wait;
+    long total_response;
+    long total_turnaround;
+    long dispatches;
+    long preemptions;
+    long context_switches;
+};
+
+// 메모리/CPU 통계
+struct MemStats {
+    long refs;
+    long faults;
+    long evictions;
+    long frame_waits;      // 모든 프레임이 Page In 중이라 빈 프레임을 기다린 Tick 수 (Fault 수에는 포함하지 않음)
+    long fault_wait_sum;   // Page Fault -> Page In 완료까지 대기 시간 합
+    long disk_busy;        // Paging 디스크가 일한 Tick 수
+    long user_ticks;       // 프로세스가 접근을 모두 마치고 진행한 Tick
+    long fault_ticks;      // Page Fault로 중단된 Tick (Fault 처리에 쓴 CPU 시간)
+    long idle_page_ticks;  // 실행할 프로세스가 없고 Page In을 기다리는 프로세스가 있는 Tick
+    long idle_io_ticks;    // 그 밖의 유휴 Tick (장치 I/O 대기 또는 모두 중단)
+    long suspensions, resumes;
+};
+
+// 3. 전역 변수
+int sys_tick = 0;               // 시스템 현재 시간 (Tick)
+int t_quantum = T_QUANTUM;
+int child_count = CHILD_COUNT;
+int sim_limit = SIM_LIMIT;
+uint64_t seed = 1;
+SchedStats stats = {};
+MemStats mem = {};
+
+// 메모리 설정
+int total_frames = TOTAL_FRAMES;
+int proc_pages = PROC_PAGES;
+int ws_pages = WS_PAGES;
+int ws_locality = WS_LOCALITY;
+int ws_phase = WS_PHASE;
+int refs_per_tick = REFS_PER_TICK;
+int fault_ticks = FAULT_TICKS;
+bool load_control = false;
+int ws_window = WS_WINDOW;
+
+// [Reverse Map] 프레임 -> 주인 (term2의 frame_table), 교체는 전역 CLOCK
+struct FrameInfo {
+    int owner;       // p_table 인덱스 (-1: 비어 있음)
+    long vpn;
+    bool referenced; // CLOCK 참조 비트
+    bool loading;    // Page In 진행 중 (교체 대상에서 제외)
+};
+std::vector<FrameInfo> frame_table;
+std::vector<int> free_frames;
+int clock_hand = 0;
+int disk_free_at = 0;           // Paging 디스크가 다음 요청을 시작할 수 있는 시각 (요청은 도착 순서대로 처리)
+
+// Hashed Timing Wheel (term1과 같음): Block된 프로세스를 해제 시각 기준 슬롯에 보관
+struct TimerWheel {
+    std::vector<int> slots[WHEEL_SLOTS]; // p_table 인덱스 (만료 시각 % WHEEL_SLOTS)
+    size_t pending = 0;
+
+    void clear() {
+        for (auto& s : slots) s.clear();
+        pending = 0;
+    }
+
+    void schedule(int idx, int expire_tick) {
+        slots[expire_tick & (WHEEL_SLOTS - 1)].push_back(idx);
+        pending++;
+    }
+
+    // tick에 만료되는 항목을 out에 꺼냄 (슬롯에 남은 항목은 이후 바퀴에 만료)
+    void expire(int tick, const std::vector<ProcInfo>& p_table, std::vector<int>& out) {
+        std::vector<int>& slot = slots[tick & (WHEEL_SLOTS - 1)];
+        for (size_t i = 0; i < slot.size(); ) {
+            if (p_table[slot[i]].io_done <= tick) {
+                out.push_back(slot[i]);
+                slot[i] = slot.back();
+                slot.pop_back();
+                pending--;
+            } else {
+                ++i;
+            }
+        }
+    }
+};
+
+TimerWheel wait_wheel;
+
+static uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// 3-1. 스케줄링 정책 (term1과 같음)
+enum EnqueueReason {
+    ENQ_NEW,        // 최초 생성
+    ENQ_WAKEUP,     // I/O 완료 (새 CPU Burst 시작)
+    ENQ_PAGED_IN,   // Page In 완료 (같은 CPU Burst를 이어서 실행)
+    ENQ_EXPIRED,    // Time Quantum 만료
+    ENQ_PREEMPTED   // 우선순위가 더 높은 프로세스에 의해 선점
+};
+
+class Scheduler {
+public:
+    virtual ~Scheduler() {}
+    virtual const char* name() const = 0;
+    virtual void enqueue(ProcInfo& p, EnqueueReason why) = 0;
+    virtual int pick_next() = 0;                            // 다음 실행 프로세스를 꺼냄 (없으면 -1)
+    virtual int time_slice(const ProcInfo& p) const = 0;    // Dispatch 시 할당할 Quantum
+    virtual bool should_preempt(const ProcInfo& running) const { return false; }
+    virtual void on_run_tick(ProcInfo& p) {}                // 실행 중인 프로세스가 1 Tick 소비
+    virtual void on_system_tick(int tick, std::vector<ProcInfo>& p_table) {}
+    virtual size_t size() const = 0;
+};
+
+// Round-Robin: FIFO 큐, 고정 Quantum
+class RRScheduler : public Scheduler {
+    std::deque<int> q;
+public:
+    const char* name() const override { return "rr"; }
+    void enqueue(ProcInfo& p, EnqueueReason why) override { q.push_back(p.pid); }
+    int pick_next() override {
+        if (q.empty()) return -1;
+        int pid = q.front();
+        q.pop_front();
+        return pid;
+    }
+    int time_slice(const ProcInfo& p) const override { return t_quantum; }
+    size_t size() const override { return q.size(); }
+};
+
+// MLFQ: Quantum을 다 쓰면 한 단계 강등, 주기적으로 전체를 최상위 단계로 올림
+class MLFQScheduler : public Scheduler {
+    std::deque<int> q[MLFQ_LEVELS];
+    size_t count = 0;
+public:
+    const char* name() const override { return "mlfq"; }
+    void enqueue(ProcInfo& p, EnqueueReason why) override {
+        if (why == ENQ_NEW) p.mlfq_level = 0;
+        else if (why == ENQ_EXPIRED && p.mlfq_level < MLFQ_LEVELS - 1) p.mlfq_level++;
+        q[p.mlfq_level].push_back(p.pid);
+        count++;
+    }
+    int pick_next() override {
+        for (auto& level : q) {
+            if (level.empty()) continue;
+            int pid = level.front();
+            level.pop_front();
+            count--;
+            return pid;
+        }
+        return -1;
+    }
+    int time_slice(const ProcInfo& p) const override { return t_quantum << p.mlfq_level; }
+    bool should_preempt(const ProcInfo& running) const override {
+        for (int lv = 0; lv < running.mlfq_level; ++lv) {
+            if (!q[lv].empty()) return true;
+        }
+        return false;
+    }
+    void on_system_tick(int tick, std::vector<ProcInfo>& p_table) override {
+        if (tick % MLFQ_BOOST != 0) return;
+        for (int lv = 1; lv < MLFQ_LEVELS; ++lv) {
+            q[0].insert(q[0].end(), q[lv].begin(), q[lv].end());
+            q[lv].clear();
+        }
+        for (auto& p : p_table) p.mlfq_level = 0;
+    }
+    size_t size() const override { return count; }
+};
+
+// SJF / SRTF: 남은 CPU Burst가 가장 짧은 프로세스 우선 (이진 힙)
+class SJFScheduler : public Scheduler {
+    struct Entry { int cpu_time; long seq; int pid; };
+    struct Longer {
+        bool operator()(const Entry& a, const Entry& b) const {
+            return a.cpu_time != b.cpu_time ? a.cpu_time > b.cpu_time : a.seq > b.seq;
+        }
+    };
+    std::vector<Entry> heap;
+    long seq = 0;
+    bool preemptive;
+public:
+    explicit SJFScheduler(bool srtf) : preemptive(srtf) {}
+    const char* name() const override { return preemptive ? "srtf" : "sjf"; }
+    void enqueue(ProcInfo& p, EnqueueReason why) override {
+        heap.push_back({p.cpu_time, seq++, p.pid});
+        std::push_heap(heap.begin(), heap.end(), Longer());
+    }
+    int pick_next() override {
+        if (heap.empty()) return -1;
+        std::pop_heap(heap.begin(), heap.end(), Longer());
+        int pid = heap.back().pid;
+        heap.pop_back();
+        return pid;
+    }
+    int time_slice(const ProcInfo& p) const override { return INT_MAX; } // I/O 요청(또는 Page Fault)까지 실행
+    bool should_preempt(const ProcInfo& running) const override {
+        return preemptive && !heap.empty() && heap.front().cpu_time < running.cpu_time;
+    }
+    size_t size() const override { return heap.size(); }
+};
+
+// CFS: vruntime이 가장 작은 프로세스 우선 (std::set = Red-Black Tree)
+class CFSScheduler : public Scheduler {
+    struct Entry {
+        long vruntime; long seq; int pid;
+        bool operator<(const Entry& o) const { return vruntime != o.vruntime ? vruntime < o.vruntime : seq < o.seq; }
+    };
+    std::set<Entry> tree;
+    long min_vruntime = 0;
+    long seq = 0;
+public:
+    const char* name() const override { return "cfs"; }
+    void enqueue(ProcInfo& p, EnqueueReason why) override {
+        // 새로 생성되거나 깨어난 프로세스는 min_vruntime 근처에서 시작 (독점 방지)
+        if (why == ENQ_NEW || why == ENQ_WAKEUP || why == ENQ_PAGED_IN) p.vruntime = std::max(p.vruntime, min_vruntime - CFS_LATENCY / 2);
+        tree.insert({p.vruntime, seq++, p.pid});
+    }
+    int pick_next() override {
+        if (tree.empty()) return -1;
+        auto it = tree.begin();
+        min_vruntime = std::max(min_vruntime, it->vruntime);
+        int pid = it->pid;
+        tree.erase(it);
+        return pid;
+    }
+    int time_slice(const ProcInfo& p) const override {
+        return std::max(CFS_MIN_GRAN, CFS_LATENCY / (int)(tree.size() + 1));
+    }
+    bool should_preempt(const ProcInfo& running) const override {
+        return !tree.empty() && tree.begin()->vruntime + CFS_WAKEUP_GRAN < running.vruntime;
+    }
+    void on_run_tick(ProcInfo& p) override { p.vruntime++; }
+    size_t size() const override { return tree.size(); }
+};
+
+Scheduler* make_scheduler(const char* name) {
+    if (strcmp(name, "rr") == 0) return new RRScheduler();
+    if (strcmp(name, "mlfq") == 0) return new MLFQScheduler();
+    if (strcmp(name, "sjf") == 0) return new SJFScheduler(false);
+    if (strcmp(name, "srtf") == 0) return new SJFScheduler(true);
+    if (strcmp(name, "cfs") == 0) return new CFSScheduler();
+    return nullptr;
+}
+
+// CPU (코어 1개)
+struct Cpu {
+    Scheduler* rq = nullptr;
+    int running = -1;           // 실행 중인 프로세스의 p_table 인덱스
+    int q_counter = 0;          // 남은 Time Quantum
+    int last = -1;              // 직전에 실행한 프로세스 (Context Switch 판단용)
+};
+
+Cpu cpu;
+
+// Ready 상태로 전환 (대기 시간 측정 시작)
+void make_ready(ProcInfo& p, EnqueueReason why) {
+    p.ready_since = sys_tick;
+    if (why == ENQ_NEW || why == ENQ_WAKEUP) {
+        p.burst_start = sys_tick;
+        p.responded = false;
+    }
+    p.in_rq = true;
+    cpu.rq->enqueue(p, why);
+}
+
+// 4. 사용자 워크로드
+// CPU Burst 1~10 Tick, 장치 I/O 5~14 Tick (term1 기본 워크로드와 같은 범위)
+int next_burst(ProcInfo& p) { return (int)(splitmix64(p.rng) % 10) + 1; }
+int next_io(ProcInfo& p) { return (int)(splitmix64(p.rng) % 10) + 5; }
+
+// 메모리 접근: ws_locality% 확률로 현재 Working Set 안, 나머지는 전체 페이지 중 균등
+// ws_phase번 접근마다 Working Set 위치가 바뀜
+long next_vpn(ProcInfo& p) {
+    if (p.retry_vpn >= 0) {
+        long vpn = p.retry_vpn;
+        p.retry_vpn = -1;
+        return vpn;
+    }
+    if (p.refs % ws_phase == 0) p.ws_base = (int)(splitmix64(p.rng) % proc_pages);
+    p.refs++;
+    uint64_t r = splitmix64(p.rng);
+    int page;
+    if ((int)(r % 100) < ws_locality) page = (p.ws_base + (int)((r >> 8) % ws_pages)) % proc_pages;
+    else page = (int)((r >> 8) % proc_pages);
+    return HEAP_BASE_VPN + page;
+}
+
+// Working Set Window를 한 칸 밀어 Working Set 크기 갱신 (Load Control 전용)
+void ws_reference(ProcInfo& p, long vpn) {
+    if (p.ws_count[vpn]++ == 0) p.wss++;
+    p.ws_refs.push_back(vpn);
+    if ((int)p.ws_refs.size() <= ws_window) return;
+    long old = p.ws_refs.front();
+    p.ws_refs.pop_front();
+    auto it = p.ws_count.find(old);
+    if (--it->second == 0) {
+        p.ws_count.erase(it);
+        p.wss--;
+    }
+}
+
+// 5. 메모리 관리 (Page Fault -> Block)
+
+// 프레임의 페이지를 주인의 Page Table에서 내림
+void evict_frame(int frame, std::vector<ProcInfo>& p_table) {
+    FrameInfo& f = frame_table[frame];
+    if (f.owner < 0) return;
+    ProcInfo& owner = p_table[f.owner];
+    owner.page_table->pte(f.vpn).valid = false;
+    owner.resident--;
+    f.owner = -1;
+}
+
+// 빈 프레임, 없으면 CLOCK으로 고른 Victim (모든 프레임이 Page In 중이면 -1)
+int alloc_frame(std::vector<ProcInfo>& p_table) {
+    if (!free_frames.empty()) {
+        int f = free_frames.back();
+        free_frames.pop_back();
+        return f;
+    }
+    for (int scanned = 0; scanned < total_frames * 2; scanned++) {
+        int f = clock_hand;
+        clock_hand = (clock_hand + 1) % total_frames;
+        FrameInfo& fi = frame_table[f];
+        if (fi.loading) continue;
+        if (fi.referenced) { fi.referenced = false; continue; }
+        evict_frame(f, p_table);
+        mem.evictions++;
+        return f;
+    }
+    return -1;
+}
+
+// Page In 시작: 프레임을 확보하고 디스크 읽기를 요청함
+// 디스크는 한 번에 한 요청만 처리하므로 Fault가 몰리면 대기 시간이 길어짐
+// 모든 프레임이 Page In 중이면 Wait Queue에 남은 채 다음 Tick에 다시 시도 (CPU를 쓰지 않고 Fault로도 세지 않음)
+void start_page_in(ProcInfo& p, int idx, std::vector<ProcInfo>& p_table) {
+    p.pending_frame = alloc_frame(p_table);
+    if (p.pending_frame < 0) {
+        mem.frame_waits++;
+        p.io_done = sys_tick + 1;
+    } else {
+        mem.faults++;
+        p.faults++;
+        frame_table[p.pending_frame] = {idx, p.retry_vpn, false, true};
+        int start = std::max(sys_tick, disk_free_at);
+        p.io_done = start + fault_ticks;
+        disk_free_at = p.io_done;
+        mem.disk_busy += fault_ticks;
+    }
+    wait_wheel.schedule(idx, p.io_done);
+}
+
+// Page Fault: 프로세스를 Wait Queue로 보내고 Page In을 시작함
+void page_fault(ProcInfo& p, int idx, long vpn, std::vector<ProcInfo>& p_table) {
+    p.retry_vpn = vpn;
+    p.is_waiting = true;
+    p.wait = WAIT_PAGE;
+    p.fault_wait_sum -= sys_tick; // 완료 시 더함
+    mem.fault_wait_sum -= sys_tick;
+    start_page_in(p, idx, p_table);
+}
+
+// 6. Wait Queue 처리 (장치 I/O 완료, Page In 완료)
+void handle_wakeups(std::vector<ProcInfo>& p_table) {
+    static std::vector<int> done;
+    done.clear();
+    wait_wheel.expire(sys_tick, p_table, done);
+    std::sort(done.begin(), done.end());
+
+    for (int idx : done) {
+        ProcInfo& p = p_table[idx];
+        EnqueueReason why = ENQ_WAKEUP;
+        if (p.wait == WAIT_PAGE) {
+            if (p.pending_frame < 0) { // 빈 프레임 대기 중: 다시 시도
+                start_page_in(p, idx, p_table);
+                continue;
+            }
+            FrameInfo& f = frame_table[p.pending_frame];
+            f.loading = false;
+            f.referenced = true;
+            PageEntry& e = p.page_table->pte(f.vpn);
+            e.valid = true;
+            e.frame_number = p.pending_frame;
+            p.resident++;
+            p.fault_wait_sum += sys_tick;
+            mem.fault_wait_sum += sys_tick;
+            why = ENQ_PAGED_IN;
+        }
+        p.is_waiting = false;
+        p.wait = WAIT_NONE;
+        if (!p.suspended) make_ready(p, why);
+    }
+}
+
+// 6-1. Load Control: 활성 프로세스의 Working Set 합이 프레임 수를 넘으면 가장 나중에 활성화된 프로세스를 중단해
+// 프레임을 모두 회수하고, 여유가 생기면 마지막으로 중단한 프로세스부터 재개 (term2의 --load-control과 같은 규칙)
+std::vector<int> active_order;
+std::vector<int> suspended_stack;
+
+void balance_load(std::vector<ProcInfo>& p_table) {
+    long demand = 0;
+    for (int idx : active_order) demand += std::max(1, p_table[idx].wss);
+    bool changed = false;
+    while (demand > total_frames && active_order.size() > 1) {
+        // Page In을 기다리는 프로세스는 건너뜀 (읽는 프레임을 돌려받을 방법이 없음)
+        auto it = std::find_if(active_order.rbegin(), active_order.rend(),
+                               [&](int idx) { return p_table[idx].wait != WAIT_PAGE; });
+        if (it == active_order.rend()) break;
+        int idx = *it;
+        active_order.erase(std::next(it).base());
+        ProcInfo& p = p_table[idx];
+        p.suspended = true;
+        if (cpu.running == idx) cpu.running = -1;
+        for (int f = 0; f < total_frames; f++) {
+            if (frame_table[f].owner != idx || frame_table[f].loading) continue;
+            evict_frame(f, p_table);
+            free_frames.push_back(f);
+        }
+        suspended_stack.push_back(idx);
+        demand -= std::max(1, p.wss);
+        mem.suspensions++;
+        changed = true;
+    }
+    if (!changed && !suspended_stack.empty() && demand + std::max(1, p_table[suspended_stack.back()].wss) <= total_frames) {
+        int idx = suspended_stack.back();
+        suspended_stack.pop_back();
+        ProcInfo& p = p_table[idx];
+        p.suspended = false;
+        active_order.push_back(idx);
+        if (!p.is_waiting && !p.in_rq) make_ready(p, ENQ_PREEMPTED);
+        mem.resumes++;
+    }
+}
+
+// 7. 스케줄링 (term1의 schedule_core, 코어 1개)
+void schedule(std::vector<ProcInfo>& p_table) {
+    if (cpu.running != -1 && cpu.rq->should_preempt(p_table[cpu.running])) {
+        make_ready(p_table[cpu.running], ENQ_PREEMPTED);
+        stats.preemptions++;
+        cpu.running = -1;
+    }
+    while (cpu.running == -1 && cpu.rq->size() > 0) {
+        int idx = cpu.rq->pick_next() - 1;
+        ProcInfo& next = p_table[idx];
+        next.in_rq = false;
+        if (next.suspended) continue; // 중단된 프로세스는 Run Queue에서 늦게 제거
+
+        cpu.running = idx;
+        cpu.q_counter = cpu.rq->time_slice(next);
+        stats.dispatches++;
+        stats.total_wait += sys_tick - next.ready_since;
+        if (!next.responded) {
+            next.responded = true;
+            stats.total_response += sys_tick - next.burst_start;
+        }
+        if (cpu.last != idx) stats.context_switches++;
+        cpu.last = idx;
+    }
+}
+
+// 실행 중인 프로세스가 1 Tick 동안 refs_per_tick번 메모리에 접근
+// Page Fault가 나면 그 자리에서 Block되고 남은 Tick은 Fault 처리에 쓴 것으로 봄
+void run_tick(std::vector<ProcInfo>& p_table) {
+    if (cpu.running == -1) {
+        bool paging = false;
+        for (const auto& p : p_table) paging = paging || (p.wait == WAIT_PAGE && !p.suspended);
+        if (paging) mem.idle_page_ticks++;
+        else mem.idle_io_ticks++;
+        return;
+    }
+    int idx = cpu.running;
+    ProcInfo& p = p_table[idx];
+    for (int i = 0; i < refs_per_tick; i++) {
+        long vpn = next_vpn(p);
+        int frame = p.page_table->translate(vpn);
+        if (frame < 0) {
+            page_fault(p, idx, vpn, p_table);
+            mem.fault_ticks++;
+            cpu.running = -1;
+            return;
+        }
+        mem.refs++;
+        frame_table[frame].referenced = true;
+        if (load_control) ws_reference(p, vpn);
+    }
+
+    // 모든 접근을 마친 Tick: CPU Burst 진행 (term1의 finish_tick)
+    mem.user_ticks++;
+    p.cpu_ticks++;
+    p.cpu_time--;
+    cpu.q_counter--;
+    cpu.rq->on_run_tick(p);
+    if (p.cpu_time <= 0) {
+        // CPU Burst 완료 -> 장치 I/O 요청 (Block)
+        stats.bursts++;
+        stats.total_turnaround += sys_tick - p.burst_start + 1;
+        p.bursts++;
+        p.is_waiting = true;
+        p.wait = WAIT_IO;
+        p.io_done = sys_tick + next_io(p);
+        wait_wheel.schedule(idx, p.io_done);
+        p.cpu_time = next_burst(p);
+        cpu.running = -1;
+    } else if (cpu.q_counter <= 0) {
+        make_ready(p, ENQ_EXPIRED);
+        cpu.running = -1;
+    }
+}
+
+// 8. 시뮬레이션 실행
+struct SimResult {
+    int procs;
+    SchedStats sched;
+    MemStats mem;
+    int ticks;
+};
+
+SimResult run_simulation(const char* policy, int procs) {
+    sys_tick = 0;
+    stats = {};
+    mem = {};
+    wait_wheel.clear();
+    cpu = Cpu();
+    cpu.rq = make_scheduler(policy);
+    frame_table.assign(total_frames, {-1, -1, false, false});
+    free_frames.clear();
+    for (int f = total_frames - 1; f >= 0; f--) free_frames.push_back(f); // 0번부터 할당
+    clock_hand = 0;
+    disk_free_at = 0;
+    active_order.clear();
+    suspended_stack.clear();
+
+    std::vector<ProcInfo> p_table(procs);
+    for (int i = 0; i < procs; i++) {
+        ProcInfo& p = p_table[i];
+        p.pid = i + 1;
+        p.wait = WAIT_NONE;
+        p.page_table = new RadixPageTable();
+        p.retry_vpn = -1;
+        p.pending_frame = -1;
+        p.rng = seed ^ ((uint64_t)i * 0x100000001B3ULL);
+        splitmix64(p.rng);
+        p.cpu_time = next_burst(p);
+        active_order.push_back(i);
+    }
+    for (auto& p : p_table) make_ready(p, ENQ_NEW);
+
+    while (sys_tick < sim_limit) {
+        sys_tick++;
+        handle_wakeups(p_table);
+        cpu.rq->on_system_tick(sys_tick, p_table);
+        if (load_control) balance_load(p_table);
+        schedule(p_table);
+        run_tick(p_table);
+    }
+
+    for (auto& p : p_table) {
+        // 끝나지 않은 Page In 대기는 종료 시각까지로 계산
+        if (p.wait == WAIT_PAGE) { p.fault_wait_sum += sys_tick; mem.fault_wait_sum += sys_tick; }
+        delete p.page_table;
+    }
+    delete cpu.rq;
+    cpu.rq = nullptr;
+    return {procs, stats, mem, sys_tick};
+}
+
+// 8-1. 결과 출력
+double pct(long part, long whole) { return whole > 0 ? part * 100.0 / whole : 0.0; }
+
+void print_summary(const char* policy, const SimResult& r) {
+    long n = r.sched.bursts > 0 ? r.sched.bursts : 1;
+    printf("\n[ Scheduling Summary: policy=%s, quantum=%d, procs=%d, ticks=%d ]\n", policy, t_quantum, r.procs, r.ticks);
+    printf("Completed Bursts : %ld (%.2f per 1000 ticks)\n", r.sched.bursts, r.sched.bursts * 1000.0 / r.ticks);
+    printf("Avg Wait         : %.2f ticks\n", (double)r.sched.total_wait / n);
+    printf("Avg Response     : %.2f ticks\n", (double)r.sched.total_response / n);
+    printf("Avg Turnaround   : %.2f ticks (Page In 대기 포함)\n", (double)r.sched.total_turnaround / n);
+    printf("Dispatches       : %ld (preemptions %ld, context switches %ld)\n", r.sched.dispatches, r.sched.preemptions,
+           r.sched.context_switches);
+
+    const MemStats& m = r.mem;
+    printf("\n[ Memory Summary: frames=%d, pages/proc=%d, working set=%d (%d%%), fault=%d ticks ]\n", total_frames,
+           proc_pages, ws_pages, ws_locality, fault_ticks);
+    printf("Memory Refs      : %ld | Page Faults: %ld (%.2f per 1000 refs) | Evictions: %ld | Frame Waits: %ld\n",
+           m.refs, m.faults, m.refs ? m.faults * 1000.0 / m.refs : 0.0, m.evictions, m.frame_waits);
+    printf("Avg Page In Wait : %.2f ticks | Paging Disk Util: %.2f%%\n", m.faults ? (double)m.fault_wait_sum / m.faults : 0.0,
+           pct(std::min<long>(m.disk_busy, r.ticks), r.ticks));
+    printf("CPU Utilization  : %.2f%% (user) | %.2f%% fault | %.2f%% idle on paging | %.2f%% idle on I/O\n",
+           pct(m.user_ticks, r.ticks), pct(m.fault_ticks, r.ticks), pct(m.idle_page_ticks, r.ticks),
+           pct(m.idle_io_ticks, r.ticks));
+    if (load_control) printf("Load Control     : %ld suspensions, %ld resumes (window %d refs)\n", m.suspensions, m.resumes, ws_window);
+}
+
+// 다중 프로그래밍 정도별 비교: 프로세스 수를 늘리면 CPU 이용률이 오르다가 Working Set 합이 프레임 수를 넘는 지점부터 무너짐
+void print_sweep(const char* policy, const std::vector<SimResult>& results) {
+    printf("\n==== Multiprogramming Sweep (policy=%s, frames=%d, working set=%d, fault=%d ticks%s) ====\n", policy,
+           total_frames, ws_pages, fault_ticks, load_control ? ", load control" : "");
+    printf("%-6s %-8s %-8s %-10s %-8s %-13s %-14s %-10s %-10s\n", "Procs", "CPU(%)", "Fault(%)", "PageIdle%",
+           "IOIdle%", "Faults/1kRef", "Bursts/1kTick", "Disk(%)", "PageWait");
+    printf("------------------------------------------------------------------------------------------------\n");
+    for (const SimResult& r : results) {
+        const MemStats& m = r.mem;
+        printf("%-6d %-8.2f %-8.2f %-10.2f %-8.2f %-13.2f %-14.2f %-10.2f %-10.2f\n", r.procs, pct(m.user_ticks, r.ticks),
+               pct(m.fault_ticks, r.ticks), pct(m.idle_page_ticks, r.ticks), pct(m.idle_io_ticks, r.ticks),
+               m.refs ? m.faults * 1000.0 / m.refs : 0.0, r.sched.bursts * 1000.0 / r.ticks,
+               pct(std::min<long>(m.disk_busy, r.ticks), r.ticks), m.faults ? (double)m.fault_wait_sum / m.faults : 0.0);
+    }
+}
+
+void print_usage(const char* prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("  -t, --ticks N       시뮬레이션 Tick 수 (기본값 %d)\n", SIM_LIMIT);
+    printf("  -n, --procs N       사용자 프로세스 수 (기본값 %d)\n", CHILD_COUNT);
+    printf("  -p, --policy P      스케줄링 정책: rr(기본값) | mlfq | sjf | srtf | cfs\n");
+    printf("  -q, --quantum N     RR/MLFQ 기본 Time Quantum (기본값 %d)\n", T_QUANTUM);
+    printf("  -s, --seed S        워크로드 난수 시드 (기본값 1)\n");
+    printf("  -f, --frames N      물리 프레임 수 (기본값 %d)\n", TOTAL_FRAMES);
+    printf("  -P, --pages N       프로세스당 가상 페이지 수 (기본값 %d)\n", PROC_PAGES);
+    printf("  -w, --ws-size N     Working Set 크기 (기본값 %d)\n", WS_PAGES);
+    printf("      --locality P    Working Set 안을 접근할 확률 (기본값 %d%%)\n", WS_LOCALITY);
+    printf("      --phase N       Working Set 위치가 바뀌는 주기, 접근 수 (기본값 %d)\n", WS_PHASE);
+    printf("  -r, --refs N        실행 Tick당 메모리 접근 수 (기본값 %d)\n", REFS_PER_TICK);
+    printf("  -F, --fault-time T  Paging 디스크의 페이지 읽기 시간 (기본값 %d Tick, 요청은 한 번에 하나씩)\n", FAULT_TICKS);
+    printf("  -c, --load-control  Working Set 합이 프레임 수를 넘으면 프로세스를 중단해 Thrashing 방지\n");
+    printf("      --ws-window N   Load Control용 Working Set Window, 접근 수 (기본값 %d)\n", WS_WINDOW);
+    printf("  -S, --sweep LIST    프로세스 수 목록(예: 1,2,4,8,16,32)마다 실행해 CPU 이용률 비교 표 출력\n");
+    printf("  -h, --help          도움말 출력\n");
+}
+
+// 9. 메인 함수
+int main(int argc, char* argv[]) {
+    static const struct option long_opts[] = {
+        {"ticks",     required_argument, NULL, 't'},
+        {"procs",     required_argument, NULL, 'n'},
+        {"policy",    required_argument, NULL, 'p'},
+        {"quantum",   required_argument, NULL, 'q'},
+        {"seed",      required_argument, NULL, 's'},
+        {"frames",    required_argument, NULL, 'f'},
+        {"pages",     required_argument, NULL, 'P'},
+        {"ws-size",   required_argument, NULL, 'w'},
+        {"locality",  required_argument, NULL, 1000},
+        {"phase",     required_argument, NULL, 1001},
+        {"refs",      required_argument, NULL, 'r'},
+        {"fault-time", required_argument, NULL, 'F'},
+        {"load-control", no_argument,    NULL, 'c'},
+        {"ws-window", required_argument, NULL, 1002},
+        {"sweep",     required_argument, NULL, 'S'},
+        {"help",      no_argument,       NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    const char* policy = "rr";
+    const char* sweep_list = NULL;
+    int opt;
+    while ((opt = getopt_long(argc, argv, "t:n:p:q:s:f:P:w:r:F:cS:h", long_opts, NULL)) != -1) {
+        switch (opt) {
+            case 't': sim_limit = atoi(optarg); break;
+            case 'n': child_count = atoi(optarg); break;
+            case 'p': policy = optarg; break;
+            case 'q': t_quantum = atoi(optarg); break;
+            case 's': seed = strtoull(optarg, NULL, 0); break;
+            case 'f': total_frames = atoi(optarg); break;
+            case 'P': proc_pages = atoi(optarg); break;
+            case 'w': ws_pages = atoi(optarg); break;
+            case 1000: ws_locality = atoi(optarg); break;
+            case 1001: ws_phase = atoi(optarg); break;
+            case 'r': refs_per_tick = atoi(optarg); break;
+            case 'F': fault_ticks = atoi(optarg); break;
+            case 'c': load_control = true; break;
+            case 1002: ws_window = atoi(optarg); break;
+            case 'S': sweep_list = optarg; break;
+            case 'h': print_usage(argv[0]); return 0;
+            default:  print_usage(argv[0]); return 1;
+        }
+    }
+    Scheduler* probe = make_scheduler(policy);
+    if (!probe) { fprintf(stderr, "unknown policy: %s\n", policy); return 1; }
+    delete probe;
+    if (sim_limit <= 0) { fprintf(stderr, "invalid tick count\n"); return 1; }
+    if (t_quantum <= 0) { fprintf(stderr, "invalid time quantum\n"); return 1; }
+    if (child_count <= 0) { fprintf(stderr, "invalid process count\n"); return 1; }
+    if (total_frames <= 0 || proc_pages <= 0 || ws_pages <= 0 || ws_pages > proc_pages || ws_locality < 0 ||
+        ws_locality > 100 || ws_phase <= 0 || refs_per_tick <= 0 || fault_ticks <= 0 || ws_window <= 0) {
+        fprintf(stderr, "invalid memory parameter\n");
+        return 1;
+    }
+
+    if (!sweep_list) {
+        print_summary(policy, run_simulation(policy, child_count));
+        return 0;
+    }
+
+    std::vector<SimResult> results;
+    std::string list(sweep_list);
+    size_t pos = 0;
+    while (pos <= list.size()) {
+        size_t comma = list.find(',', pos);
+        if (comma == std::string::npos) comma = list.size();
+        int procs = atoi(list.substr(pos, comma - pos).c_str());
+        if (procs <= 0) { fprintf(stderr, "invalid sweep list: %s\n", sweep_list); return 1; }
+        results.push_back(run_simulation(policy, procs));
+        pos = comma + 1;
+    }
+    print_sweep(policy, results);
+    return 0;
+}